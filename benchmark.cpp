@@ -0,0 +1,266 @@
+// benchmark.cpp
+// In-process benchmark of the tabu solver: the solver is linked as a library and the phases
+// (board load, cost matrix, solve, optional lower bound) are timed separately, with warmup,
+// repeats and the measuring thread pinned to one CPU. One CSV row per (board, phase).
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#include "benchmark.h"
+#include "perf_counters.h"
+#include "part1/generate_board.h"
+
+#include "part2/TSP.h"
+#include "part2/TSPSolver.h"
+#include "part2/LowerBound.h"
+
+const std::string BOARD_DIR = "benchmark_boards";
+const std::string TRACE_DIR = "benchmark_traces";
+const std::vector<std::pair<int, int>> DEFAULT_BOARDS = {{10, 10}, {20, 40}, {30, 180}, {50, 500}};
+
+struct BenchOptions {
+    int warmup = 1;
+    int repeats = 5;
+    int cpu = 0;                 // < 0: no pinning
+    int iterations = 1000;
+    int tabuLength = 10;
+    unsigned int seed = 1;       // same seed for every repeat: identical work, only the timing varies
+    bool symmetric = false;
+    bool lowerBound = false;
+    bool instrument = false;     // one extra, untimed instrumented solve per board (summary + trace)
+    bool perf = false;           // hardware counters per phase (perf_event_open)
+    std::string perfOutput = "bench_perf.csv";
+    std::string output = "bench_results.csv";
+    std::string label = "";      // e.g. the commit id, to compare runs in the same file
+    std::vector<std::string> boards;
+};
+
+struct PhaseResult {
+    std::string phase;
+    SampleStats stats;
+    double value;                // solution value / bound (-1: not applicable)
+    PerfSample counters;         // mean over the repeats (all -1 without --perf)
+};
+
+bool file_exists(const std::string& filename) {
+    struct stat buffer;
+    return (stat(filename.c_str(), &buffer) == 0);
+}
+
+// Time every phase on one board: warmup runs are discarded, then 'repeats' samples per phase.
+// With counters, each phase is also bracketed by counters->start()/stop(), outside its timed interval.
+std::vector<PhaseResult> bench_board(const std::string& filename, const BenchOptions& opt, int& holes,
+                                     PerfCounters* counters) {
+    std::vector<double> load_t, matrix_t, solve_t, bound_t;
+    std::vector<PerfSample> load_c, matrix_c, solve_c, bound_c;
+    double value = -1.0, bound = -1.0;
+    PerfSample c;
+
+    auto begin = [counters]() { if (counters) counters->start(); return now_sec(); };
+    auto end = [counters, &c]() { double t = now_sec(); if (counters) c = counters->stop(); return t; };
+
+    for (int r = 0; r < opt.warmup + opt.repeats; ++r) {
+        bool measured = (r >= opt.warmup);
+        TSP tsp;
+
+        double t0 = begin();
+        if (!tsp.load(filename.c_str())) throw std::runtime_error("cannot load board " + filename);
+        double t1 = end();
+        if (measured) load_c.push_back(c);
+        double t1b = begin();
+        tsp.computeCostMatrix(opt.symmetric);
+        double t2 = end();
+        if (measured) matrix_c.push_back(c);
+
+        TSPSolver solver("");
+        solver.setVerbose(false);
+        solver.setSeed(opt.seed);
+        TSPSolution init(tsp), best(tsp);
+        solver.initRnd(init);
+        double t3 = begin();
+        solver.solve(tsp, init, opt.tabuLength, opt.iterations, best);
+        double t4 = end();
+        if (measured) solve_c.push_back(c);
+        value = solver.evaluate(best, tsp);
+
+        double t5 = t4, t6 = t4;
+        if (opt.lowerBound) {
+            t5 = begin();
+            bound = TSPLowerBound(tsp).heldKarp(value);
+            t6 = end();
+            if (measured) bound_c.push_back(c);
+        }
+
+        holes = tsp.n;
+        if (!measured) continue;
+        load_t.push_back(t1 - t0);
+        matrix_t.push_back(t2 - t1b);
+        solve_t.push_back(t4 - t3);
+        if (opt.lowerBound) bound_t.push_back(t6 - t5);
+    }
+
+    std::vector<PhaseResult> results = {
+        {"load", summarize(load_t), -1.0, mean_sample(load_c)},
+        {"matrix", summarize(matrix_t), -1.0, mean_sample(matrix_c)},
+        {"solve", summarize(solve_t), value, mean_sample(solve_c)}
+    };
+    if (opt.lowerBound) results.push_back({"bound", summarize(bound_t), bound, mean_sample(bound_c)});
+    return results;
+}
+
+// Instrumented solve (same seed as the timed ones): where the search time goes on this board
+void instrument_board(const std::string& filename, const BenchOptions& opt) {
+    TSP tsp;
+    if (!tsp.load(filename.c_str())) return;
+    tsp.computeCostMatrix(opt.symmetric);
+    Instrumentation instr;
+    TSPSolver solver("");
+    solver.setVerbose(false);
+    solver.setSeed(opt.seed);
+    solver.setInstrumentation(&instr);
+    TSPSolution init(tsp), best(tsp);
+    solver.initRnd(init);
+    solver.solve(tsp, init, opt.tabuLength, opt.iterations, best);
+
+    std::string base = filename.substr(filename.find_last_of('/') + 1);
+    std::string trace = TRACE_DIR + "/" + base.substr(0, base.find_last_of('.')) + ".trace.json";
+    mkdir(TRACE_DIR.c_str(), 0755);
+    std::cout << filename << " (" << tsp.n << " holes)" << std::endl;
+    instr.printSummary(std::cout);
+    if (instr.writeTrace(trace)) std::cout << "trace: " << trace << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions opt;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.find("--warmup=") == 0) opt.warmup = std::stoi(arg.substr(9));
+            else if (arg.find("--repeats=") == 0) opt.repeats = std::stoi(arg.substr(10));
+            else if (arg.find("--cpu=") == 0) opt.cpu = std::stoi(arg.substr(6));
+            else if (arg.find("--maxIterations=") == 0) opt.iterations = std::stoi(arg.substr(16));
+            else if (arg.find("--seed=") == 0) opt.seed = std::stoul(arg.substr(7));
+            else if (arg.find("--output=") == 0) opt.output = arg.substr(9);
+            else if (arg.find("--label=") == 0) opt.label = arg.substr(8);
+            else if (arg == "--symmetric") opt.symmetric = true;
+            else if (arg == "--lowerBound") opt.lowerBound = true;
+            else if (arg == "--instrument") opt.instrument = true;
+            else if (arg == "--perf") opt.perf = true;
+            else if (arg.find("--perfOutput=") == 0) { opt.perfOutput = arg.substr(13); opt.perf = true; }
+            else if (arg.find("--") == 0) {
+                std::cerr << "Usage: " << argv[0] << " [board.dat ...] [--warmup=1 --repeats=5 --cpu=0 "
+                             "--maxIterations=1000 --seed=1 --symmetric --lowerBound --instrument --perf --perfOutput=bench_perf.csv --output=bench_results.csv --label=name]" << std::endl;
+                return 1;
+            }
+            else opt.boards.push_back(arg);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid argument: " << e.what() << std::endl;
+        return 1;
+    }
+    if (opt.repeats < 1) opt.repeats = 1;
+
+    // default board set: generated once, reused by later runs so results stay comparable
+    if (opt.boards.empty()) {
+        mkdir(BOARD_DIR.c_str(), 0755);
+        for (const auto& b : DEFAULT_BOARDS) {
+            std::string fname = BOARD_DIR + "/bench_" + std::to_string(b.first) + "_" + std::to_string(b.second) + ".dat";
+            if (!file_exists(fname)) generateBoard(b.first, b.second, fname, b.first * 1000u + b.second);
+            opt.boards.push_back(fname);
+        }
+    }
+
+    if (!pin_thread(opt.cpu)) {
+        std::cerr << "Warning: could not pin to CPU " << opt.cpu << ", timings may be noisier" << std::endl;
+    }
+
+    bool write_header = !file_exists(opt.output);
+    std::ofstream out(opt.output, std::ios::app);
+    if (!out) {
+        std::cerr << "Could not open output file: " << opt.output << std::endl;
+        return 1;
+    }
+    if (write_header) {
+        out << "label,board,holes,symmetric,phase,repeats,min_sec,median_sec,p95_sec,mean_sec,value\n";
+    }
+
+    // counters: per phase and board, in their own file (empty fields for unavailable events)
+    PerfCounters counters;
+    std::ofstream perf_out;
+    if (opt.perf) {
+        int opened = counters.open();
+        if (!counters.anyHardware()) {
+            std::cerr << "Warning: hardware performance counters unavailable (" << opened
+                      << " software events only; check perf_event_paranoid or the VM)" << std::endl;
+        }
+        bool perf_header = !file_exists(opt.perfOutput);
+        perf_out.open(opt.perfOutput, std::ios::app);
+        if (!perf_out) {
+            std::cerr << "Could not open output file: " << opt.perfOutput << std::endl;
+            return 1;
+        }
+        if (perf_header) {
+            perf_out << "label,board,holes,symmetric,phase,repeats,median_sec";
+            for (int e = 0; e < NUM_PERF_EVENTS; ++e) perf_out << "," << PERF_EVENTS[e].name;
+            perf_out << ",ipc,cache_miss_rate,branch_miss_rate\n";
+        }
+    }
+
+    for (const std::string& board : opt.boards) {
+        int holes = 0;
+        std::vector<PhaseResult> results;
+        try {
+            results = bench_board(board, opt, holes, opt.perf ? &counters : nullptr);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            continue;
+        }
+        for (const PhaseResult& r : results) {
+            out << opt.label << ","
+                << board << ","
+                << holes << ","
+                << opt.symmetric << ","
+                << r.phase << ","
+                << r.stats.count << ","
+                << std::setprecision(6) << r.stats.min << ","
+                << r.stats.median << ","
+                << r.stats.p95 << ","
+                << r.stats.mean << ","
+                << r.value << "\n";
+            std::cout << board << " (" << holes << " holes) " << std::setw(6) << r.phase
+                      << ": median " << r.stats.median << "s, p95 " << r.stats.p95 << "s" << std::endl;
+        }
+        out.flush();
+        if (opt.perf) {
+            for (const PhaseResult& r : results) {
+                perf_out << opt.label << "," << board << "," << holes << "," << opt.symmetric << ","
+                         << r.phase << "," << r.stats.count << "," << std::setprecision(6) << r.stats.median;
+                for (int e = 0; e < NUM_PERF_EVENTS; ++e) {
+                    perf_out << ",";
+                    if (r.counters.value[e] >= 0) perf_out << std::setprecision(12) << r.counters.value[e];
+                }
+                double ratios[3] = {perf_ratio(r.counters, "instructions", "cycles"),
+                                    perf_ratio(r.counters, "cache_misses", "cache_references"),
+                                    perf_ratio(r.counters, "branch_misses", "branches")};
+                for (double v : ratios) {
+                    perf_out << ",";
+                    if (v >= 0) perf_out << std::setprecision(4) << v;
+                }
+                perf_out << "\n";
+                if (ratios[0] >= 0) {
+                    std::cout << "  " << std::setw(6) << r.phase << ": IPC " << std::setprecision(3) << ratios[0]
+                              << ", cache misses " << 100 * ratios[1] << "%, branch misses " << 100 * ratios[2] << "%" << std::endl;
+                }
+            }
+            perf_out.flush();
+        }
+        if (opt.instrument) instrument_board(board, opt);
+    }
+
+    std::cout << "Benchmark complete. Results appended to " << opt.output << std::endl;
+    return 0;
+}
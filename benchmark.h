@@ -0,0 +1,82 @@
+// benchmark.h
+// Timing helpers shared by the in-process benchmark binaries
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <pthread.h>
+#include <sched.h>
+
+// Wall-clock seconds from a monotonic clock
+inline double now_sec() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Order statistics of a set of repeated measurements
+struct SampleStats {
+    int count = 0;
+    double min = 0.0;
+    double median = 0.0;
+    double p95 = 0.0;
+    double mean = 0.0;
+};
+
+// Nearest-rank percentile of sorted samples (q in [0, 1])
+inline double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(q * sorted.size() + 0.999999);
+    if (rank < 1) rank = 1;
+    return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+inline SampleStats summarize(std::vector<double> samples) {
+    SampleStats s;
+    s.count = samples.size();
+    if (samples.empty()) return s;
+    std::sort(samples.begin(), samples.end());
+    s.min = samples.front();
+    s.median = (samples.size() % 2 == 1) ? samples[samples.size() / 2]
+                                         : 0.5 * (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]);
+    s.p95 = percentile(samples, 0.95);
+    for (double v : samples) s.mean += v;
+    s.mean /= samples.size();
+    return s;
+}
+
+// Pin the calling thread to one CPU (cpu < 0: leave the affinity alone)
+inline bool pin_thread(int cpu) {
+    if (cpu < 0) return true;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+// Value (in MB) of a "Key:   value kB" line of a /proc file (-1 if unavailable)
+inline double proc_kb_field_mb(const char* path, const std::string& key) {
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, key.size(), key) == 0 && line.size() > key.size() && line[key.size()] == ':') {
+            std::istringstream ss(line.substr(key.size() + 1));
+            double kb = -1.0;
+            ss >> kb;
+            return kb < 0 ? -1.0 : kb / 1024.0;
+        }
+    }
+    return -1.0;
+}
+
+// Resident set size of this process, and its peak
+inline double current_rss_mb() { return proc_kb_field_mb("/proc/self/status", "VmRSS"); }
+inline double peak_rss_mb() { return proc_kb_field_mb("/proc/self/status", "VmHWM"); }
+
+// Memory the kernel can still hand out without swapping
+inline double available_memory_mb() { return proc_kb_field_mb("/proc/meminfo", "MemAvailable"); }
+
+#endif // BENCHMARK_H
@@ -4,17 +4,26 @@
 #include <vector>
 #include <algorithm>
 #include <iomanip>
+#include <sstream>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
 #include <set>
 #include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <limits>
 
 #include "part1/generate_board.h"
 
 #include "part2/TSPSolver.h"
 #include "part2/TSP.h"       
+#include "part2/TourConstruction.h"
+#include "part2/WorkStealingPool.h"
 
 const std::string OUTPUT_DIR = "parameter_tuning";
 const std::string CSV_FILENAME = "tuning_results.csv";
@@ -50,6 +59,68 @@ struct TuningResult {
     std::string board_filename;
 };
 
+// One generated board: loaded once, shared read-only by all its tuning jobs
+struct BoardTask {
+    int size;
+    double density;
+    int holes;
+    int repeat;
+    std::string filename;
+    TSP tsp;
+
+    std::mutex mtx;              // protects best and remaining
+    TuningResult best;
+    int remaining;
+};
+
+// Single writer thread: workers hand over finished rows, only this thread touches the CSV file
+class CsvWriter {
+public:
+    explicit CsvWriter(std::ofstream& out) : out(out), writer(&CsvWriter::run, this) {}
+
+    void push(const std::string& row, const std::string& message) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            rows.push_back({row, message});
+        }
+        cv.notify_one();
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            closed = true;
+        }
+        cv.notify_one();
+        writer.join();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true) {
+            cv.wait(lock, [this] { return closed || !rows.empty(); });
+            if (rows.empty()) return;
+            std::deque<std::pair<std::string, std::string>> batch;
+            batch.swap(rows);
+            lock.unlock();
+            for (const auto& r : batch) {
+                out << r.first;
+                std::cout << r.second << std::endl;
+            }
+            out.flush();
+            lock.lock();
+        }
+    }
+
+    std::ofstream& out;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<std::pair<std::string, std::string>> rows;
+    bool closed = false;
+    std::thread writer;
+};
+
 bool file_exists(const std::string& name) {
     std::ifstream f(name.c_str());
     return f.good();
@@ -64,11 +135,25 @@ std::string combine_path(const std::string& dir, const std::string& filename) {
 
 int main(int argc, char* argv[]) {
     bool save_logs = false;
-    if (argc > 1 && std::string(argv[1]) == "--save-logs") {
-        save_logs = true;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    ConstructionMethod init_method = CONSTRUCT_RANDOM;   // initial tour of every run
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--save-logs") {
+            save_logs = true;
+        } else if (arg.find("--threads=") == 0) {
+            num_threads = std::stoi(arg.substr(10));
+        } else if (arg.find("--init=") == 0) {
+            if (!TourConstruction::parseMethod(arg.substr(7), init_method)) {
+                std::cerr << "Error: unknown initial tour " << arg.substr(7) << " (random, nn, greedy, sfc, christofides)" << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Warning: Unknown parameter: " << arg << std::endl;
+        }
     }
 
-    srand(static_cast<unsigned int>(time(nullptr)));
+    unsigned int base_seed = static_cast<unsigned int>(time(nullptr));
 
     std::string mkdir_command = "mkdir -p " + OUTPUT_DIR;
     int mkdir_result = std::system(mkdir_command.c_str());
@@ -90,6 +175,8 @@ int main(int argc, char* argv[]) {
         csv_file << "size,density,holes,repeat,alpha,beta,decayFactor,lambda,final_cost,time_sec,board_filename\n";
     }
 
+    // Generate and load every board once
+    std::vector<std::unique_ptr<BoardTask>> boards;
     for (int size : SIZES) {
         int total_cells = size * size;
         for (double density : DENSITIES) {
@@ -101,42 +188,62 @@ int main(int argc, char* argv[]) {
 
             for (int r = 0; r < REPEATS; ++r) {
                 std::string original_board_fname = combine_path(OUTPUT_DIR, "board_" + std::to_string(size) + "_" + std::to_string(num_holes) + "_" + std::to_string(r) + ".dat");
-                
-                generateBoard(size, num_holes, original_board_fname);
-                
+
+                generateBoard(size, num_holes, original_board_fname, base_seed + 1000000u * size + 1000u * num_holes + r);
+
                 if (!file_exists(original_board_fname)) {
                     std::cerr << "Error: Board file " << original_board_fname << " was not created. Skipping." << std::endl;
                     continue;
                 }
 
-                TuningResult best_result;
-                best_result.final_cost = std::numeric_limits<double>::infinity();
-
-                int idx = 0;
-                for (double alpha : ALPHAS) {
-                    for (double beta : BETAS) {
-                        for (double decay_factor : DECAY_FACTORS) {
-                            for (double lambda : LAMBDAS) {
-                                std::string current_log_fname = combine_path(OUTPUT_DIR, "board_" + std::to_string(size) + "_" + std::to_string(num_holes) + "_" + std::to_string(r) + "_run" + std::to_string(idx) + "_log.txt");
-                                idx++;
-
-                                TSP tspInstance;
-                                try {
-                                    tspInstance.read(original_board_fname.c_str());
-                                } catch (const std::exception& e) {
-                                    std::cerr << "Error reading board file " << original_board_fname << ": " << e.what() << std::endl;
-                                    if (file_exists(current_log_fname)) {
-                                        std::remove(current_log_fname.c_str());
-                                    }
-                                    continue;
-                                }
+                std::unique_ptr<BoardTask> board(new BoardTask());
+                board->size = size;
+                board->density = density;
+                board->holes = num_holes;
+                board->repeat = r;
+                board->filename = original_board_fname;
+                try {
+                    board->tsp.read(original_board_fname.c_str());
+                } catch (const std::exception& e) {
+                    std::cerr << "Error reading board file " << original_board_fname << ": " << e.what() << std::endl;
+                    continue;
+                }
+                board->best.final_cost = std::numeric_limits<double>::infinity();
+                board->remaining = ALPHAS.size() * BETAS.size() * DECAY_FACTORS.size() * LAMBDAS.size();
+                boards.push_back(std::move(board));
+            }
+        }
+    }
 
+    CsvWriter writer(csv_file);
+    {
+        WorkStealingPool pool(num_threads);
+        std::cout << "Running tuning jobs on " << pool.size() << " threads" << std::endl;
+
+        for (size_t b = 0; b < boards.size(); ++b) {
+            BoardTask* board = boards[b].get();
+            int idx = 0;
+            for (double alpha : ALPHAS) {
+                for (double beta : BETAS) {
+                    for (double decay_factor : DECAY_FACTORS) {
+                        for (double lambda : LAMBDAS) {
+                            std::string current_log_fname = "";
+                            if (save_logs) {
+                                current_log_fname = combine_path(OUTPUT_DIR, "board_" + std::to_string(board->size) + "_" + std::to_string(board->holes) + "_" + std::to_string(board->repeat) + "_run" + std::to_string(idx) + "_log.txt");
+                            }
+                            unsigned int seed = base_seed + static_cast<unsigned int>(b * 1000 + idx);
+                            idx++;
+
+                            pool.submit([board, &writer, current_log_fname, seed, init_method, alpha, beta, decay_factor, lambda]() {
+                                const TSP& tspInstance = board->tsp;
                                 TSPSolution aSolution(tspInstance);
 
                                 auto start_time = std::chrono::high_resolution_clock::now();
 
                                 TSPSolver tspSolver(current_log_fname, alpha, beta, decay_factor, lambda);
-                                tspSolver.initRnd(aSolution);
+                                tspSolver.setVerbose(false);
+                                tspSolver.setSeed(seed);
+                                if (!TourConstruction(tspInstance).build(init_method, aSolution)) tspSolver.initRnd(aSolution);
 
                                 TSPSolution current_best_solution(tspInstance);
                                 int tabuLength = 10;
@@ -149,50 +256,53 @@ int main(int argc, char* argv[]) {
 
                                 double current_final_cost = tspSolver.evaluate(current_best_solution, tspInstance);
 
-                                if (current_final_cost >= 0 && current_final_cost < best_result.final_cost) {
-                                    best_result = {
-                                        size, density, num_holes, r,
+                                std::lock_guard<std::mutex> lock(board->mtx);
+                                if (current_final_cost >= 0 && current_final_cost < board->best.final_cost) {
+                                    board->best = {
+                                        board->size, board->density, board->holes, board->repeat,
                                         alpha, beta, decay_factor, lambda,
                                         current_final_cost, time_taken,
-                                        original_board_fname
+                                        board->filename
                                     };
                                 }
 
-                                if (!save_logs && file_exists(current_log_fname)) {
-                                    std::remove(current_log_fname.c_str());
+                                if (--board->remaining > 0) return;
+
+                                // last configuration of this board: hand the best row to the writer
+                                const TuningResult& best_result = board->best;
+                                std::ostringstream row, message;
+                                if (best_result.final_cost != std::numeric_limits<double>::infinity()) {
+                                    row << best_result.size << ","
+                                        << best_result.density << ","
+                                        << best_result.holes << ","
+                                        << best_result.repeat << ","
+                                        << best_result.alpha << ","
+                                        << best_result.beta << ","
+                                        << best_result.decayFactor << ","
+                                        << best_result.lambda << ","
+                                        << std::fixed << std::setprecision(4) << best_result.final_cost << ","
+                                        << std::fixed << std::setprecision(4) << best_result.time_sec << ","
+                                        << best_result.board_filename << "\n";
+                                    message << "Best tuning result for size=" << board->size << ", density=" << board->density
+                                            << ", repeat=" << board->repeat << " saved. Cost: " << best_result.final_cost;
+                                } else {
+                                    message << "No valid solution found for size=" << board->size << ", density=" << board->density
+                                            << ", repeat=" << board->repeat;
                                 }
-                            }
+                                writer.push(row.str(), message.str());
+
+                                if (file_exists(board->filename)) {
+                                    std::remove(board->filename.c_str());
+                                }
+                            });
                         }
                     }
                 }
-
-                if (best_result.final_cost != std::numeric_limits<double>::infinity()) {
-                    csv_file << best_result.size << ","
-                             << best_result.density << ","
-                             << best_result.holes << ","
-                             << best_result.repeat << ","
-                             << best_result.alpha << ","
-                             << best_result.beta << ","
-                             << best_result.decayFactor << ","
-                             << best_result.lambda << ","
-                             << std::fixed << std::setprecision(4) << best_result.final_cost << ","
-                             << std::fixed << std::setprecision(4) << best_result.time_sec << ","
-                             << best_result.board_filename << "\n";
-                    csv_file.flush();
-
-                    std::cout << "Best tuning result for size=" << size << ", density=" << density
-                              << ", repeat=" << r << " saved. Cost: " << best_result.final_cost << std::endl;
-                } else {
-                    std::cout << "No valid solution found for size=" << size << ", density=" << density
-                              << ", repeat=" << r << std::endl;
-                }
-
-                if (file_exists(original_board_fname)) {
-                    std::remove(original_board_fname.c_str());
-                }
             }
         }
+        pool.wait();
     }
+    writer.close();
 
     csv_file.close();
     std::cout << "Parameter tuning complete. Results saved to " << CSV_FILENAME << std::endl;
@@ -0,0 +1,112 @@
+// parse_benchmark.cpp
+// Dense .dat board loading: the former ifstream parser (one formatted read per cell into a full grid)
+// against the mmap byte scanner of part1/board_io, on large generated boards.
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iomanip>
+#include <sys/stat.h>
+
+#include "benchmark.h"
+#include "part1/generate_board.h"
+#include "part1/board_io.h"
+
+bool file_exists(const std::string& filename) {
+    struct stat buffer;
+    return (stat(filename.c_str(), &buffer) == 0);
+}
+
+// The parser TSP::read used before board_io: kept here as the baseline
+std::vector<std::pair<int, int>> legacy_parse(const std::string& filename) {
+    std::ifstream file(filename);
+    int gridSize;
+    file >> gridSize;
+
+    std::vector<std::vector<int>> grid(gridSize, std::vector<int>(gridSize));
+    std::vector<std::pair<int, int>> holes;
+
+    for (int i = 0; i < gridSize; ++i) {
+        for (int j = 0; j < gridSize; ++j) {
+            int val;
+            file >> val;
+            grid[i][j] = val;
+            if (val == 1) {
+                holes.push_back({j, i});  // (x = col, y = row)
+            }
+        }
+    }
+    return holes;
+}
+
+int main(int argc, char* argv[]) {
+    int size = 5000;
+    double density = 0.05;
+    int repeats = 5;
+    std::string output = "parse_results.csv";
+    std::string label = "";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.find("--size=") == 0) size = std::stoi(arg.substr(7));
+        else if (arg.find("--density=") == 0) density = std::stod(arg.substr(10));
+        else if (arg.find("--repeats=") == 0) repeats = std::stoi(arg.substr(10));
+        else if (arg.find("--output=") == 0) output = arg.substr(9);
+        else if (arg.find("--label=") == 0) label = arg.substr(8);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--size=5000 --density=0.05 --repeats=5 --output=parse_results.csv --label=name]" << std::endl;
+            return 1;
+        }
+    }
+
+    int holes = static_cast<int>((double)size * size * density);
+    std::string board = "parse_bench_" + std::to_string(size) + "_" + std::to_string(holes) + ".dat";
+    if (!file_exists(board) && !generateBoard(size, holes, board, 4242u)) return 1;
+    struct stat st;
+    stat(board.c_str(), &st);
+    double megabytes = st.st_size / (1024.0 * 1024.0);
+
+    std::vector<double> legacy_t, mmap_t;
+    std::vector<std::pair<int, int>> reference;
+    bool same = true;
+    for (int r = 0; r < repeats + 1; ++r) {          // first round is a warmup (page cache)
+        double t0 = now_sec();
+        std::vector<std::pair<int, int>> a = legacy_parse(board);
+        double t1 = now_sec();
+        BoardFile loaded;
+        if (!loaded.open(board)) {
+            std::cerr << loaded.error() << std::endl;
+            return 1;
+        }
+        double t2 = now_sec();
+        if (r == 0) {
+            same = (a.size() == loaded.count());
+            for (size_t k = 0; same && k < a.size(); ++k) {
+                same = (a[k].first == loaded.holes()[k].x && a[k].second == loaded.holes()[k].y);
+            }
+            continue;
+        }
+        legacy_t.push_back(t1 - t0);
+        mmap_t.push_back(t2 - t1);
+    }
+    if (!same) {
+        std::cerr << "Parsers disagree on " << board << std::endl;
+        return 1;
+    }
+
+    SampleStats legacy = summarize(legacy_t), fast = summarize(mmap_t);
+    bool write_header = !file_exists(output);
+    std::ofstream out(output, std::ios::app);
+    if (write_header) out << "label,board,size,holes,file_mb,parser,repeats,median_sec,p95_sec,mb_per_sec\n";
+    out << label << "," << board << "," << size << "," << holes << "," << megabytes << ",legacy," << legacy.count << ","
+        << legacy.median << "," << legacy.p95 << "," << megabytes / legacy.median << "\n";
+    out << label << "," << board << "," << size << "," << holes << "," << megabytes << ",mmap," << fast.count << ","
+        << fast.median << "," << fast.p95 << "," << megabytes / fast.median << "\n";
+
+    std::cout << std::setprecision(4)
+              << board << " (" << megabytes << " MB, " << holes << " holes)\n"
+              << "  legacy ifstream: median " << legacy.median << " s (" << megabytes / legacy.median << " MB/s)\n"
+              << "  mmap scanner:    median " << fast.median << " s (" << megabytes / fast.median << " MB/s)\n"
+              << "  speedup x" << legacy.median / fast.median << std::endl;
+    return 0;
+}
@@ -0,0 +1,236 @@
+#include "board_io.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Next (optionally signed) decimal integer in [p, end); nullptr if there is none
+static const char* scanInt(const char* p, const char* end, long& value) {
+    while (p < end && std::isspace((unsigned char)*p)) ++p;
+    bool negative = (p < end && *p == '-');
+    if (negative) ++p;
+    if (p == end || *p < '0' || *p > '9') return nullptr;
+    long v = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) v = v * 10 + (*p - '0');
+    value = negative ? -v : v;
+    return p;
+}
+
+// Number of whitespace-separated tokens in [p, end), counting stops at 'limit'
+static long countTokens(const char* p, const char* end, long limit) {
+    long tokens = 0;
+    while (tokens < limit) {
+        while (p < end && std::isspace((unsigned char)*p)) ++p;
+        if (p == end) break;
+        ++tokens;
+        while (p < end && !std::isspace((unsigned char)*p)) ++p;
+    }
+    return tokens;
+}
+
+bool BoardFile::fail(const std::string& message) {
+    lastError = message;
+    close();
+    return false;
+}
+
+void BoardFile::close() {
+    if (mapping) munmap(mapping, mappingLength);
+    mapping = nullptr;
+    mappingLength = 0;
+    owned.clear();
+    data = nullptr;
+    numHoles = 0;
+    boardSize = 0;
+}
+
+bool BoardFile::open(const std::string& filename) {
+    close();
+    lastError.clear();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return fail("cannot open " + filename);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return fail("empty or unreadable file " + filename);
+    }
+    size_t length = st.st_size;
+    void* map = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return fail("cannot map " + filename);
+    const char* bytes = static_cast<const char*>(map);
+
+    // binary: keep the mapping, holes are read in place
+    if (length >= sizeof(BinaryBoardHeader) && std::memcmp(bytes, BOARD_BINARY_MAGIC, sizeof(BOARD_BINARY_MAGIC)) == 0) {
+        mapping = map;
+        mappingLength = length;
+        fileFormat = BOARD_SPARSE_BINARY;
+        const BinaryBoardHeader* header = static_cast<const BinaryBoardHeader*>(map);
+        if (header->size == 0 || header->size > INT32_MAX) return fail("bad binary board header " + filename);
+        if (header->count > (length - sizeof(BinaryBoardHeader)) / sizeof(Hole)) return fail("truncated binary board " + filename);
+        const Hole* holes = reinterpret_cast<const Hole*>(bytes + sizeof(BinaryBoardHeader));
+        int32_t size = header->size;
+        for (uint64_t i = 0; i < header->count; ++i) {   // consumers index by coordinates: read-only check of the mapping
+            if (holes[i].x < 0 || holes[i].y < 0 || holes[i].x >= size || holes[i].y >= size) {
+                return fail("hole outside the board (" + filename + ")");
+            }
+        }
+        boardSize = header->size;
+        numHoles = header->count;
+        data = holes;
+        return true;
+    }
+
+    // text: "size" then size x size cells (dense grid) or "size n" then n "x y" pairs (hole list).
+    // The header tokens decide, wherever the line breaks are: after the size a grid goes on with a
+    // 0/1 cell, a hole list with its count; a count of 0 or 1 is a hole list only if exactly 2n
+    // coordinates follow (a grid has size^2 cells)
+    const char* end = bytes + length;
+    long size = 0, second = 0;
+    const char* afterSize = scanInt(bytes, end, size);
+    const char* afterSecond = afterSize ? scanInt(afterSize, end, second) : nullptr;
+    bool sparse = afterSecond && ((second != 0 && second != 1) || countTokens(afterSecond, end, 3) == 2 * second);
+
+    bool ok;
+    if (sparse) {
+        fileFormat = BOARD_SPARSE_TEXT;
+        ok = parseSparseText(bytes, end);
+    } else {
+        fileFormat = BOARD_DENSE;
+        ok = parseDense(bytes, end);
+    }
+    munmap(map, length);
+    if (!ok) return fail(lastError + " (" + filename + ")");
+    data = owned.data();
+    numHoles = owned.size();
+    return true;
+}
+
+bool BoardFile::parseSparseText(const char* p, const char* end) {
+    long size = 0, count = 0;
+    if (!(p = scanInt(p, end, size)) || !(p = scanInt(p, end, count)) || size <= 0 || count < 0) {
+        lastError = "bad hole list header";
+        return false;
+    }
+    boardSize = size;
+    owned.reserve(count);
+    for (long i = 0; i < count; ++i) {
+        long x = 0, y = 0;
+        if (!(p = scanInt(p, end, x)) || !(p = scanInt(p, end, y))) {
+            lastError = "hole list shorter than its header";
+            return false;
+        }
+        if (x < 0 || y < 0 || x >= size || y >= size) {
+            lastError = "hole outside the board";
+            return false;
+        }
+        owned.push_back({(int32_t)x, (int32_t)y});
+    }
+    return true;
+}
+
+bool BoardFile::parseDense(const char* p, const char* end) {
+    long size = 0;
+    if (!(p = scanInt(p, end, size)) || size < 0) {
+        lastError = "bad grid header";
+        return false;
+    }
+    boardSize = size;
+
+    // canonical layout (as written by writeBoard): "size\n", then every row is "c c ... c \n", 2 * size + 1
+    // bytes. Then the position of a '1' byte gives its cell, so we only jump from '1' to '1' with memchr
+    // (vectorized in libc) and never look at the zeros.
+    size_t rowLength = 2 * (size_t)size + 1;
+    const char* body = p + 1;
+    bool canonical = p < end && *p == '\n' && (size_t)(end - body) == (size_t)size * rowLength;
+    for (long r = 0; canonical && r < size; ++r) canonical = (body[r * rowLength + rowLength - 1] == '\n');
+    if (canonical) {
+        for (const char* q = body; (q = static_cast<const char*>(std::memchr(q, '1', end - q))) != nullptr; ++q) {
+            size_t offset = q - body;
+            size_t col = offset % rowLength;
+            if (col % 2 != 0 || col >= rowLength - 1) {
+                canonical = false;   // a '1' outside a cell slot: not single-digit cells after all
+                owned.clear();
+                break;
+            }
+            owned.push_back({(int32_t)(col / 2), (int32_t)(offset / rowLength)});  // (x = col, y = row)
+        }
+        if (canonical) return true;
+    }
+
+    // any other spacing (rows may even start on the header line): a plain stream of size^2 cells,
+    // token by token, still without building the grid
+    long cells = size * size;
+    long cell = 0;
+    while (cell < cells) {
+        while (p < end && std::isspace((unsigned char)*p)) ++p;
+        if (p == end) break;
+        const char* token = p;
+        while (p < end && !std::isspace((unsigned char)*p)) ++p;
+        if (p - token == 1 && *token == '1') owned.push_back({(int32_t)(cell % size), (int32_t)(cell / size)});
+        ++cell;
+    }
+    if (cell < cells) {
+        lastError = "grid shorter than its header";
+        return false;
+    }
+    return true;
+}
+
+BoardFormat boardFormatFromExtension(const std::string& filename) {
+    size_t dot = filename.find_last_of('.');
+    std::string ext = (dot == std::string::npos) ? "" : filename.substr(dot);
+    if (ext == ".dat") return BOARD_DENSE;
+    if (ext == ".hlb") return BOARD_SPARSE_BINARY;
+    return BOARD_SPARSE_TEXT;
+}
+
+bool writeBoard(const std::string& filename, BoardFormat format, int size, const Hole* holes, size_t count) {
+    FILE* out = std::fopen(filename.c_str(), format == BOARD_SPARSE_BINARY ? "wb" : "w");
+    if (!out) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+        return false;
+    }
+    std::vector<char> buffer(1 << 20);
+    std::setvbuf(out, buffer.data(), _IOFBF, buffer.size());
+
+    bool ok = true;
+    if (format == BOARD_SPARSE_BINARY) {
+        BinaryBoardHeader header;
+        std::memcpy(header.magic, BOARD_BINARY_MAGIC, sizeof(header.magic));
+        header.size = size;
+        header.reserved = 0;
+        header.count = count;
+        ok = std::fwrite(&header, sizeof(header), 1, out) == 1
+          && std::fwrite(holes, sizeof(Hole), count, out) == count;
+    } else if (format == BOARD_SPARSE_TEXT) {
+        ok = std::fprintf(out, "%d %zu\n", size, count) > 0;
+        for (size_t i = 0; i < count && ok; ++i) ok = std::fprintf(out, "%d %d\n", holes[i].x, holes[i].y) > 0;
+    } else {
+        // dense grid, one row at a time
+        std::vector<Hole> sorted(holes, holes + count);
+        std::sort(sorted.begin(), sorted.end(), [](const Hole& a, const Hole& b) {
+            return a.y != b.y ? a.y < b.y : a.x < b.x;
+        });
+        std::string row(2 * (size_t)size + 1, ' ');
+        for (int x = 0; x < size; ++x) row[2 * x] = '0';
+        row.back() = '\n';
+        ok = std::fprintf(out, "%d\n", size) > 0;
+        size_t h = 0;
+        for (int y = 0; y < size && ok; ++y) {
+            size_t first = h;
+            for (; h < sorted.size() && sorted[h].y == y; ++h) row[2 * sorted[h].x] = '1';
+            ok = std::fwrite(row.data(), 1, row.size(), out) == row.size();
+            for (size_t k = first; k < h; ++k) row[2 * sorted[k].x] = '0';
+        }
+    }
+    ok = (std::fclose(out) == 0) && ok;
+    if (!ok) std::cerr << "Error writing file: " << filename << std::endl;
+    return ok;
+}
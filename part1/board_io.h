@@ -0,0 +1,74 @@
+// part1/board_io.h
+// Board files shared by both solvers:
+//   dense grid (.dat)      "size" then size x size 0/1 cells, holes numbered in raster order
+//   sparse text (.holes)   "size n" then n lines "x y"
+//   sparse binary (.hlb)   BinaryBoardHeader then n packed Hole records (native byte order)
+#ifndef BOARD_IO_H
+#define BOARD_IO_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+struct Hole {
+    int32_t x, y;   // x = column, y = row
+};
+
+enum BoardFormat {
+    BOARD_DENSE,
+    BOARD_SPARSE_TEXT,
+    BOARD_SPARSE_BINARY
+};
+
+struct BinaryBoardHeader {
+    char     magic[8];   // "DRILLHB1"
+    uint32_t size;       // board side
+    uint32_t reserved;
+    uint64_t count;      // number of holes
+};
+
+const char BOARD_BINARY_MAGIC[8] = {'D', 'R', 'I', 'L', 'L', 'H', 'B', '1'};
+
+// A loaded board. Binary files are memory-mapped and the holes are read in place (no copy, no parsing);
+// the text formats are scanned straight from the mapped bytes into an owned array (dense grids are never
+// materialized). The format is detected from the file content.
+class BoardFile {
+public:
+    BoardFile() {}
+    ~BoardFile() { close(); }
+    BoardFile(const BoardFile&) = delete;
+    BoardFile& operator=(const BoardFile&) = delete;
+
+    // Load any board format; on failure returns false and error() tells why
+    bool open(const std::string& filename);
+    void close();
+
+    int size() const { return boardSize; }
+    size_t count() const { return numHoles; }
+    const Hole* holes() const { return data; }
+    BoardFormat format() const { return fileFormat; }
+    const std::string& error() const { return lastError; }
+
+private:
+    bool parseDense(const char* begin, const char* end);
+    bool parseSparseText(const char* begin, const char* end);
+    bool fail(const std::string& message);
+
+    int boardSize = 0;
+    size_t numHoles = 0;
+    const Hole* data = nullptr;
+    std::vector<Hole> owned;       // text formats
+    void* mapping = nullptr;       // binary format
+    size_t mappingLength = 0;
+    BoardFormat fileFormat = BOARD_DENSE;
+    std::string lastError;
+};
+
+// Format implied by a file name (.dat dense, .hlb binary, anything else sparse text)
+BoardFormat boardFormatFromExtension(const std::string& filename);
+
+// Write holes in the given format (a dense grid keeps positions only: its holes are renumbered in raster order)
+bool writeBoard(const std::string& filename, BoardFormat format, int size, const Hole* holes, size_t count);
+
+#endif // BOARD_IO_H
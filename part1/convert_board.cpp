@@ -0,0 +1,37 @@
+#include "board_io.h"
+#include <iostream>
+#include <string>
+
+// Convert between board formats: dense .dat grid, sparse text hole list, sparse binary hole list
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <input board> <output board> [--format=dense|text|binary]" << std::endl;
+        std::cerr << "  the output format defaults to the extension: .dat dense, .hlb binary, otherwise text" << std::endl;
+        return 1;
+    }
+
+    std::string input = argv[1];
+    std::string output = argv[2];
+    BoardFormat format = boardFormatFromExtension(output);
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--format=dense") format = BOARD_DENSE;
+        else if (arg == "--format=text") format = BOARD_SPARSE_TEXT;
+        else if (arg == "--format=binary") format = BOARD_SPARSE_BINARY;
+        else {
+            std::cerr << "Unknown parameter: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    BoardFile board;
+    if (!board.open(input)) {
+        std::cerr << "Error reading board: " << board.error() << std::endl;
+        return 1;
+    }
+    if (!writeBoard(output, format, board.size(), board.holes(), board.count())) return 1;
+
+    std::cout << "Converted " << board.count() << " holes (" << board.size() << "x" << board.size()
+              << ") from " << input << " to " << output << std::endl;
+    return 0;
+}
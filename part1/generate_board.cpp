@@ -1,53 +1,120 @@
 #include "generate_board.h"
+#include "board_io.h"
 #include <iostream>
-#include <fstream>
-#include <vector>
-#include <cstdlib>
-#include <ctime>
-#include <set>
+#include <cmath>
+#include <random>
+#include <atomic>
+#include <algorithm>
+#include <unordered_set>
+#include <iterator>
 
-void generateBoard(int size, int num_holes, const std::string& filename) {
-    std::vector<std::vector<int>> board(size, std::vector<int>(size, 0));
-    std::set<std::pair<int, int>> used_positions;
-    srand(time(nullptr));
-
-    while (used_positions.size() < static_cast<size_t>(num_holes)) {
-        int x = rand() % size;
-        int y = rand() % size;
-        if (used_positions.insert({x, y}).second) {
-            board[y][x] = 1;
+bool parseLayout(const std::string& name, BoardLayout& layout) {
+    if (name == "uniform") layout = LAYOUT_UNIFORM;
+    else if (name == "clustered") layout = LAYOUT_CLUSTERED;
+    else if (name == "grid") layout = LAYOUT_GRID;
+    else return false;
+    return true;
+}
+
+std::vector<std::pair<int, int>> sampleHoles(int size, int num_holes, BoardLayout layout, unsigned int seed) {
+    long long cells = (long long)size * size;
+    num_holes = (int)std::max(0LL, std::min<long long>(num_holes, cells));
+
+    std::mt19937_64 rng(seed);
+    std::unordered_set<long long> used;   // cell ids y * size + x
+    used.reserve(num_holes);
+    auto add = [&](long long x, long long y) {
+        if (x < 0 || y < 0 || x >= size || y >= size || (int)used.size() >= num_holes) return;
+        used.insert(y * size + x);
+    };
+
+    if (layout == LAYOUT_CLUSTERED) {
+        int clusters = std::max(1, num_holes / 500);
+        double sigma = size / (4.0 * std::sqrt((double)clusters));
+        std::uniform_int_distribution<int> coord(0, size - 1);
+        std::vector<std::pair<int, int>> centers(clusters);
+        for (auto& c : centers) c = {coord(rng), coord(rng)};
+        std::uniform_int_distribution<int> pick(0, clusters - 1);
+        std::normal_distribution<double> offset(0.0, sigma);
+        for (long long tries = 0; (int)used.size() < num_holes && tries < 50LL * num_holes; ++tries) {
+            const auto& c = centers[pick(rng)];
+            add(std::llround(c.first + offset(rng)), std::llround(c.second + offset(rng)));
+        }
+    } else if (layout == LAYOUT_GRID) {
+        std::uniform_int_distribution<int> coord(0, size - 1);
+        std::uniform_int_distribution<int> dim(2, 12);
+        for (long long tries = 0; (int)used.size() < num_holes && tries < 50LL * num_holes; ++tries) {
+            int x0 = coord(rng), y0 = coord(rng), rows = dim(rng), cols = dim(rng);
+            for (int r = 0; r < rows; ++r)
+                for (int c = 0; c < cols; ++c) add(x0 + 2 * c, y0 + 2 * r);
         }
     }
 
-    std::ofstream outFile(filename);
-    if (!outFile) {
-        std::cerr << "Error opening file: " << filename << std::endl;
-        return;
-    }
+    // uniform layout, or whatever a saturated clustered/grid layout could not place: Floyd's algorithm
+    // picks distinct ranks among the free cells with exactly one draw each. Above half of them it picks
+    // the ranks that stay free instead, so at most min(missing, free - missing) ranks are held, and the
+    // free cells are never listed: rank r is cell r + (occupied cells before it), found by a merge.
+    std::vector<long long> occupied(used.begin(), used.end());
+    std::sort(occupied.begin(), occupied.end());
+    std::unordered_set<long long>().swap(used);
+    long long range = cells - (long long)occupied.size();
+    long long missing = num_holes - (long long)occupied.size();
+    std::vector<long long> ids;
+    if (missing > 0) {
+        bool complement = missing > range / 2;
+        long long draws = complement ? range - missing : missing;
+        std::unordered_set<long long> picked;
+        picked.reserve(draws);
+        for (long long j = range - draws; j < range; ++j) {
+            long long t = std::uniform_int_distribution<long long>(0, j)(rng);
+            picked.insert(picked.count(t) ? j : t);
+        }
+        std::vector<long long> ranks(picked.begin(), picked.end());
+        std::sort(ranks.begin(), ranks.end());
+        std::unordered_set<long long>().swap(picked);
 
-    outFile << size << "\n";
-    for (const auto& row : board) {
-        for (int cell : row) {
-            outFile << cell << " ";
+        std::vector<long long> added;
+        added.reserve(missing);
+        size_t k = 0;
+        auto cellOfRank = [&](long long r) {   // ranks in increasing order
+            while (k < occupied.size() && occupied[k] <= r + (long long)k) ++k;
+            return r + (long long)k;
+        };
+        if (complement) {
+            size_t skip = 0;
+            for (long long r = 0; r < range; ++r) {
+                if (skip < ranks.size() && ranks[skip] == r) { ++skip; continue; }
+                added.push_back(cellOfRank(r));
+            }
+        } else {
+            for (long long r : ranks) added.push_back(cellOfRank(r));
         }
-        outFile << "\n";
+        ids.reserve(occupied.size() + added.size());
+        std::merge(occupied.begin(), occupied.end(), added.begin(), added.end(), std::back_inserter(ids));
+    } else {
+        ids.swap(occupied);
     }
 
-    outFile.close();
-    std::cout << "Board saved to " << filename << std::endl;
+    std::vector<std::pair<int, int>> holes;
+    holes.reserve(ids.size());
+    for (long long id : ids) holes.push_back({(int)(id % size), (int)(id / size)});
+    return holes;
 }
 
-// int main(int argc, char* argv[]) {
-//     if (argc < 3 || argc > 4) { // Allow 3 or 4 arguments
-//         std::cerr << "Usage: " << argv[0] << " <size> <num_holes> [output_filename]" << std::endl;
-//         return 1;
-//     }
-    
-//     int size = std::stoi(argv[1]);
-//     int num_holes = std::stoi(argv[2]);
+bool generateBoard(int size, int num_holes, const std::string& filename, unsigned int seed, BoardLayout layout) {
+    std::vector<std::pair<int, int>> sampled = sampleHoles(size, num_holes, layout, seed);
+    std::vector<Hole> holes;
+    holes.reserve(sampled.size());
+    for (const auto& h : sampled) holes.push_back({h.first, h.second});
 
-//     std::string filename = (argc == 4) ? argv[3] : "board.dat"; // Use provided filename or default
+    if (!writeBoard(filename, boardFormatFromExtension(filename), size, holes.data(), holes.size())) return false;
+    std::cout << "Board saved to " << filename << std::endl;
+    return true;
+}
 
-//     generateBoard(size, num_holes, filename);
-//     return 0;
-// }
+void generateBoard(int size, int num_holes, const std::string& filename) {
+    // random_device plus a call counter: boards generated in the same second still differ
+    static std::atomic<unsigned int> calls(0);
+    unsigned int seed = std::random_device{}() ^ (0x9e3779b9u * ++calls);
+    generateBoard(size, num_holes, filename, seed, LAYOUT_UNIFORM);
+}
@@ -3,7 +3,27 @@
 #define GENERATE_BOARD_H
 
 #include <string>
+#include <vector>
+#include <utility>
 
+// Spatial distribution of the holes on the board
+enum BoardLayout {
+    LAYOUT_UNIFORM,    // every cell equally likely
+    LAYOUT_CLUSTERED,  // Gaussian clusters of ~500 holes
+    LAYOUT_GRID        // rectangular hole arrays on a pitch-2 lattice (connectors, BGA footprints)
+};
+
+// Parse "uniform" / "clustered" / "grid" (false if unknown)
+bool parseLayout(const std::string& name, BoardLayout& layout);
+
+// Distinct hole positions (x = col, y = row) of a size x size board, sorted in raster order.
+// Memory is O(num_holes), the result is fully determined by the seed.
+std::vector<std::pair<int, int>> sampleHoles(int size, int num_holes, BoardLayout layout, unsigned int seed);
+
+// Write a board, in the format implied by the file extension (see board_io.h). Returns false on I/O errors.
+bool generateBoard(int size, int num_holes, const std::string& filename, unsigned int seed, BoardLayout layout = LAYOUT_UNIFORM);
+
+// Uniform board with a fresh seed on every call
 void generateBoard(int size, int num_holes, const std::string& filename);
 
-#endif // GENERATE_BOARD_H
\ No newline at end of file
+#endif // GENERATE_BOARD_H
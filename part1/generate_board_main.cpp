@@ -0,0 +1,33 @@
+#include "generate_board.h"
+#include <iostream>
+#include <string>
+#include <random>
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <size> <num_holes> [output_filename] [--seed=S] [--layout=uniform|clustered|grid]" << std::endl;
+        return 1;
+    }
+
+    int size = std::stoi(argv[1]);
+    int num_holes = std::stoi(argv[2]);
+    std::string filename = "board.dat";
+    unsigned int seed = std::random_device{}();
+    BoardLayout layout = LAYOUT_UNIFORM;
+
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.find("--seed=") == 0) {
+            seed = std::stoul(arg.substr(7));
+        } else if (arg.find("--layout=") == 0) {
+            if (!parseLayout(arg.substr(9), layout)) {
+                std::cerr << "Unknown layout: " << arg.substr(9) << std::endl;
+                return 1;
+            }
+        } else {
+            filename = arg;
+        }
+    }
+
+    return generateBoard(size, num_holes, filename, seed, layout) ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+// part1/grid_distance.h
+// Exact distances between integer grid points, looked up by (|dx|, |dy|); shared by both solvers.
+#ifndef GRID_DISTANCE_H
+#define GRID_DISTANCE_H
+
+#include <vector>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#include "metric.h"
+
+// Table of the distance (sqrt(dx^2 + dy^2) for the Euclidean metric) for 0 <= dx, dy < side. Its size
+// depends on the board side, not on the number of holes: a dense 100 x 100 board needs 80 KB instead
+// of the n x n matrix, and the lookups return exactly the doubles that the metric would (the table is
+// filled with the same expression).
+class GridDistanceTable {
+public:
+    static const int MAX_SIDE = 2048;   // 32 MB of doubles at most
+
+    GridDistanceTable() : side(0), metric(METRIC_EUCLIDEAN) {}
+
+    // Fill the table for coordinates in [0, extent); false (table left empty) if extent > MAX_SIDE
+    bool build(int extent, DistanceMetric distanceMetric = METRIC_EUCLIDEAN) {
+        if (extent > MAX_SIDE) { clear(); return false; }
+        if (extent == side && distanceMetric == metric) return true;
+        side = extent;
+        metric = distanceMetric;
+        table.resize((size_t)side * side);
+        withMetric(metric, [this](auto policy) {
+            for (int dx = 0; dx < side; ++dx) {
+                for (int dy = 0; dy < side; ++dy) table[(size_t)dx * side + dy] = decltype(policy)::distance(dx, dy);
+            }
+        });
+        return true;
+    }
+
+    void clear() { side = 0; table.clear(); }
+    int size() const { return side; }
+    bool empty() const { return side == 0; }
+
+    double operator()(int dx, int dy) const { return table[(size_t)std::abs(dx) * side + std::abs(dy)]; }
+    double between(const std::pair<int, int>& a, const std::pair<int, int>& b) const {
+        return (*this)(a.first - b.first, a.second - b.second);
+    }
+
+    // Extent (largest coordinate + 1) of a set of holes, as (x, y) pairs or Hole records
+    template <class Holes>
+    static int extentOf(const Holes& holes) {
+        int extent = 1;
+        for (const auto& h : holes) extent = std::max(extent, std::max(xOf(h), yOf(h)) + 1);
+        return extent;
+    }
+
+private:
+    static int xOf(const std::pair<int, int>& h) { return h.first; }
+    static int yOf(const std::pair<int, int>& h) { return h.second; }
+    template <class H> static int xOf(const H& h) { return h.x; }
+    template <class H> static int yOf(const H& h) { return h.y; }
+
+    int side;
+    DistanceMetric metric;
+    std::vector<double> table;   // row dx, column dy
+};
+
+#endif // GRID_DISTANCE_H
@@ -0,0 +1,137 @@
+#include "instance_cache.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char CACHE_MAGIC[8] = {'T', 'S', 'P', 'C', 'A', 'C', 'H', '2'};
+
+static uint64_t alignUp(uint64_t offset) { return (offset + 63) & ~(uint64_t)63; }
+
+uint64_t boardHash(int size, const Hole* holes, size_t count) {
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            h ^= p[i];
+            h *= 1099511628211ULL;
+        }
+    };
+    int32_t s = size;
+    mix(&s, sizeof(s));
+    mix(holes, count * sizeof(Hole));
+    return h;
+}
+
+std::string instanceCachePath(const std::string& dir, uint64_t hash) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.tspc", (unsigned long long)hash);
+    return (dir.empty() || dir.back() == '/') ? dir + name : dir + "/" + name;
+}
+
+bool CachedInstance::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(InstanceCacheHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return false;
+
+    base = static_cast<const char*>(map);
+    length = st.st_size;
+    header = reinterpret_cast<const InstanceCacheHeader*>(base);
+    if (std::memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header->fileSize != length) {
+        close();   // foreign or truncated file: treated as a miss
+        return false;
+    }
+    return true;
+}
+
+void CachedInstance::close() {
+    if (base) munmap(const_cast<char*>(base), length);
+    base = nullptr;
+    header = nullptr;
+    length = 0;
+}
+
+bool buildInstanceCache(const std::string& path, uint64_t hash, int size, const Hole* holes, size_t count,
+                        const InstanceCacheOptions& options) {
+    int n = count;
+    InstanceCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.hash = hash;
+    header.n = n;
+    header.size = size;
+    header.hasMatrix = options.matrix && count <= options.maxMatrixNodes;
+
+    header.coordsOffset = alignUp(sizeof(header));
+    header.matrixOffset = alignUp(header.coordsOffset + count * sizeof(Hole));
+    uint64_t matrixBytes = header.hasMatrix ? (uint64_t)n * (n + 1) / 2 * sizeof(double) : 0;
+    header.fileSize = header.matrixOffset + matrixBytes;
+
+    std::string tmp = path + ".tmp." + std::to_string(getpid());
+    FILE* out = std::fopen(tmp.c_str(), "wb");
+    if (!out) {
+        std::cerr << "Cannot write instance cache " << tmp << std::endl;
+        return false;
+    }
+    std::vector<char> buffer(1 << 20);
+    std::setvbuf(out, buffer.data(), _IOFBF, buffer.size());
+
+    bool ok = true;
+    auto section = [&](uint64_t offset, const void* data, size_t bytes) {
+        static const char zeros[64] = {0};
+        long pos = std::ftell(out);
+        if (ok && pos >= 0 && (uint64_t)pos < offset) ok = std::fwrite(zeros, 1, offset - pos, out) == offset - pos;
+        if (ok && bytes > 0) ok = std::fwrite(data, 1, bytes, out) == bytes;
+    };
+    section(0, &header, sizeof(header));   // rewritten below once the matrix is known
+    section(header.coordsOffset, holes, count * sizeof(Hole));
+    if (header.hasMatrix) {
+        section(header.matrixOffset, nullptr, 0);
+        std::vector<double> row(n);
+        double total = 0.0;
+        for (int i = 0; i < n && ok; ++i) {
+            for (int j = 0; j <= i; ++j) {
+                double dx = holes[i].x - holes[j].x;
+                double dy = holes[i].y - holes[j].y;
+                row[j] = std::sqrt(dx * dx + dy * dy);
+                total += row[j];
+            }
+            ok = std::fwrite(row.data(), sizeof(double), i + 1, out) == (size_t)(i + 1);
+        }
+        // the header goes out last: it now knows the value TSP::computeCostMatrix would compute
+        header.infinite = 4 * total;
+        ok = ok && std::fseek(out, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, out) == 1;
+    }
+    ok = (std::fclose(out) == 0) && ok;
+    if (ok) ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+    if (!ok) {
+        std::remove(tmp.c_str());
+        std::cerr << "Cannot write instance cache " << path << std::endl;
+    }
+    return ok;
+}
+
+bool openInstanceCache(const BoardFile& board, const InstanceCacheOptions& options, CachedInstance& entry) {
+    uint64_t hash = boardHash(board.size(), board.holes(), board.count());
+    std::string path = instanceCachePath(options.dir, hash);
+    if (entry.open(path) && entry.hash() == hash && (size_t)entry.n() == board.count()
+        && (entry.packedMatrix() || !options.matrix || board.count() > options.maxMatrixNodes)) {
+        return true;
+    }
+    mkdir(options.dir.c_str(), 0755);
+    return buildInstanceCache(path, hash, board.size(), board.holes(), board.count(), options) && entry.open(path);
+}
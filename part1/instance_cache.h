@@ -0,0 +1,73 @@
+// part1/instance_cache.h
+// On-disk cache of preprocessed instances, keyed by a hash of the board content (size + hole list, so
+// the same board in any file format shares one entry). A cache file is laid out to be used in place
+// after mmap: header, coordinates and the optional packed distance matrix, every section 64-byte aligned.
+// Only what TSP::loadCached reads is stored (neighbour lists and spatial indexes are cheap to rebuild).
+#ifndef INSTANCE_CACHE_H
+#define INSTANCE_CACHE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "board_io.h"
+
+struct InstanceCacheOptions {
+    std::string dir = ".tsp_cache";
+    bool matrix = true;                 // store the packed distance matrix ...
+    size_t maxMatrixNodes = 10000;      // ... only up to this many holes (n(n+1)/2 doubles, 400 MB at 10k)
+};
+
+struct InstanceCacheHeader {
+    char     magic[8];        // "TSPCACH2" (version 1 entries, with neighbour lists, are rebuilt)
+    uint64_t hash;            // board content hash (also the file name)
+    uint32_t n;               // holes
+    uint32_t size;            // board side
+    uint32_t hasMatrix;
+    uint32_t reserved;
+    double   infinite;        // 2 * sum of d(i,j) over ordered pairs (TSP::infinite), 0 without matrix
+    uint64_t coordsOffset;    // n Hole
+    uint64_t matrixOffset;    // n(n+1)/2 double, lower triangle row by row (SymMatrix layout)
+    uint64_t fileSize;
+};
+
+// 64-bit FNV-1a hash of the board size and the hole list
+uint64_t boardHash(int size, const Hole* holes, size_t count);
+
+// A cache entry mapped read-only; all accessors point into the mapping
+class CachedInstance {
+public:
+    CachedInstance() {}
+    ~CachedInstance() { close(); }
+    CachedInstance(const CachedInstance&) = delete;
+    CachedInstance& operator=(const CachedInstance&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    uint64_t hash() const { return header->hash; }
+    int n() const { return header->n; }
+    int size() const { return header->size; }
+    const Hole* holes() const { return reinterpret_cast<const Hole*>(base + header->coordsOffset); }
+
+    // packed lower triangle (i >= j at i(i+1)/2 + j), nullptr if the entry has no matrix
+    const double* packedMatrix() const { return header->hasMatrix ? reinterpret_cast<const double*>(base + header->matrixOffset) : nullptr; }
+    double infinite() const { return header->infinite; }
+
+private:
+    const InstanceCacheHeader* header = nullptr;
+    const char* base = nullptr;
+    size_t length = 0;
+};
+
+// Path of the cache entry of a board
+std::string instanceCachePath(const std::string& dir, uint64_t hash);
+
+// Preprocess a board and write its cache entry (written to a temporary file, then renamed)
+bool buildInstanceCache(const std::string& path, uint64_t hash, int size, const Hole* holes, size_t count,
+                        const InstanceCacheOptions& options);
+
+// Open the cache entry of a loaded board, building it first on a miss
+bool openInstanceCache(const BoardFile& board, const InstanceCacheOptions& options, CachedInstance& entry);
+
+#endif // INSTANCE_CACHE_H
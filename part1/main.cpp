@@ -4,7 +4,12 @@
 #include <fstream>
 #include <sstream>
 #include <chrono>
+#include <cmath>
 #include "cpxmacro.h"
+#include "board_io.h"
+#include "instance_cache.h"
+#include "metric.h"
+#include "grid_distance.h"
 
 using namespace std;
 
@@ -19,63 +24,122 @@ char name[NAME_SIZE];
 vector<vector<int>> map_x;  // x_ij ---> map_x[i][j]
 vector<vector<int>> map_y;  // y_ij ---> map_y[i][j]
 
-struct Hole {
-    int x, y;
-};
-
-// Function to extract filename without extension
-std::string getSolutionFilename(const std::string& boardFilename) {
+// Function to replace the extension of the board filename (e.g. board.dat -> board.sol)
+std::string getSolutionFilename(const std::string& boardFilename, const std::string& extension = ".sol") {
     size_t lastDot = boardFilename.find_last_of(".");
     if (lastDot != std::string::npos) {
-        return boardFilename.substr(0, lastDot) + ".sol";  // Remove .dat and append .sol
+        return boardFilename.substr(0, lastDot) + extension;  // Remove .dat and append extension
     }
-    return boardFilename + ".sol";  // Fallback in case there's no .dat extension
+    return boardFilename + extension;  // Fallback in case there's no .dat extension
 }
 
-std::vector<Hole> readBoard(const std::string& filename) {
-    std::ifstream inFile(filename);
-    if (!inFile) {
-        std::cerr << "Error opening file: " << filename << std::endl;
-        exit(1);
-    }
-
-    int size;
-    inFile >> size;  // Read board size (assumed square)
-    std::vector<Hole> holes;
+// Extract the tour from the y variables: walk the selected arcs starting from 0
+// (in the symmetric model map_y[i][j] == map_y[j][i], so every node sees both its neighbours)
+std::vector<int> extractTour(CEnv env, Prob lp, int N) {
+    int numCols = CPXgetnumcols(env, lp);
+    std::vector<double> values(numCols);
+    CHECKED_CPX_CALL(CPXgetx, env, lp, values.data(), 0, numCols - 1);
 
-    for (int y = 0; y < size; ++y) {
-        for (int x = 0; x < size; ++x) {
-            int value;
-            inFile >> value;
-            if (value == 1) {
-                holes.push_back({x, y});  // Store hole position
+    std::vector<std::vector<int>> adj(N);
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            if (map_y[i][j] >= 0 && values[map_y[i][j]] > 0.5) {
+                adj[i].push_back(j);
             }
         }
     }
 
-    inFile.close();
-    return holes;
+    std::vector<int> tour;
+    tour.reserve(N + 1);
+    int prev = -1, curr = 0;
+    for (int k = 0; k < N && curr >= 0; k++) {
+        tour.push_back(curr);
+        int next = -1;
+        for (int j : adj[curr]) {
+            if (j != prev) { next = j; break; }
+        }
+        prev = curr;
+        curr = next;
+    }
+    tour.push_back(0);
+    return tour;
+}
+
+// Write the tour in the same compact format as the tabu solver (FINAL_SOLUTION / FINAL_VALUE)
+bool writeTourFile(const std::string& filename, const std::vector<int>& tour, double value) {
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << "Error opening tour file: " << filename << std::endl;
+        return false;
+    }
+    out << "FINAL_SOLUTION\n";
+    for (int node : tour) out << node << " ";
+    out << "\n";
+    out << "FINAL_VALUE " << value << "\n";
+    return true;
+}
+
+std::vector<Hole> readBoard(const std::string& filename) {
+    BoardFile board;  // dense .dat grid or sparse hole list (text / binary)
+    if (!board.open(filename)) {
+        std::cerr << "Error opening file: " << board.error() << std::endl;
+        exit(1);
+    }
+    return std::vector<Hole>(board.holes(), board.holes() + board.count());
 }
 
 
-// Function to compute the cost matrix based on the hole positions
-std::vector<std::vector<double>> computeCostMatrix(const std::vector<Hole>& holes) {
+// Function to compute the cost matrix based on the hole positions (in the given metric);
+// sqrt-based distances come from a GridDistanceTable when it is smaller than the matrix (dense boards)
+std::vector<std::vector<double>> computeCostMatrix(const std::vector<Hole>& holes, DistanceMetric metric = METRIC_EUCLIDEAN) {
     int N = holes.size();
     std::vector<std::vector<double>> C(N, std::vector<double>(N, 0));
 
-    // Compute Euclidean distances between holes
-    for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            if (i != j) {
-                double dx = holes[i].x - holes[j].x;
-                double dy = holes[i].y - holes[j].y;
-                C[i][j] = sqrt(dx * dx + dy * dy);
+    withMetric(metric, [&](auto policy) {
+        typedef decltype(policy) Metric;
+        int extent = GridDistanceTable::extentOf(holes);
+        GridDistanceTable table;
+        bool lookup = Metric::tabulated && (size_t)extent * extent <= (size_t)N * N && table.build(extent, metric);
+        for (int i = 0; i < N; i++) {
+            for (int j = 0; j < N; j++) {
+                if (i != j) {
+                    int dx = holes[i].x - holes[j].x, dy = holes[i].y - holes[j].y;
+                    C[i][j] = lookup ? table(dx, dy) : Metric::distance(dx, dy);
+                }
             }
         }
-    }
+    });
     return C;
 }
 
+// Holes and cost matrix through the on-disk instance cache (built on the first run of a board);
+// the cached matrix is Euclidean: other metrics only take the holes from the cache
+void readCachedBoard(const std::string& filename, const std::string& cacheDir, DistanceMetric metric,
+                     std::vector<Hole>& holes, std::vector<std::vector<double>>& C) {
+    BoardFile board;
+    if (!board.open(filename)) {
+        std::cerr << "Error opening file: " << board.error() << std::endl;
+        exit(1);
+    }
+    InstanceCacheOptions options;
+    options.dir = cacheDir;
+    CachedInstance entry;
+    if (!openInstanceCache(board, options, entry) || !entry.packedMatrix() || metric != METRIC_EUCLIDEAN) {
+        holes.assign(board.holes(), board.holes() + board.count());
+        C = computeCostMatrix(holes, metric);
+        return;
+    }
+    int N = entry.n();
+    holes.assign(entry.holes(), entry.holes() + N);
+    C.assign(N, std::vector<double>(N, 0));
+    const double* packed = entry.packedMatrix();
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < i; j++) {
+            C[i][j] = C[j][i] = packed[(size_t)i * (i + 1) / 2 + j];
+        }
+    }
+}
+
 void setupLP(CEnv env, Prob lp, const std::vector<std::vector<double>>& C, int N) {
     int current_var_position = 0;
 
@@ -225,26 +289,246 @@ void setupLP(CEnv env, Prob lp, const std::vector<std::vector<double>>& C, int N
     std::cout << "Finished adding constraints." << std::endl;
 }
 
+// Symmetric model: one binary y_ij (i < j) per undirected edge, degree-2 constraints, and the
+// flow capacity shared by both directions: x_ij + x_ji <= (|N| - 1) y_ij
+void setupSymmetricLP(CEnv env, Prob lp, const std::vector<std::vector<double>>& C, int N) {
+    int current_var_position = 0;
+
+    map_x.assign(N, std::vector<int>(N, -1));
+    map_y.assign(N, std::vector<int>(N, -1));
+
+    // Add x vars (directed flow, none enters node 0)
+    for (int i = 0; i < N; i++) {
+        for (int j = 1; j < N; j++) {
+            if (i == j) continue;
+            char xtype = 'C';
+            double lb = 0.0;
+            double ub = CPX_INFBOUND;
+            snprintf(name, NAME_SIZE, "x_%d_%d", i, j);
+            char* xname = (char*)(&name[0]);
+            double zero = 0.0;
+            CHECKED_CPX_CALL(CPXnewcols, env, lp, 1, &zero, &lb, &ub, &xtype, &xname);
+            map_x[i][j] = current_var_position++;
+        }
+    }
+
+    // Add y vars (undirected edges)
+    for (int i = 0; i < N; i++) {
+        for (int j = i + 1; j < N; j++) {
+            char ytype = 'B';
+            double lb = 0;
+            double ub = 1;
+            snprintf(name, NAME_SIZE, "y_%d_%d", i, j);
+            char* yname = (char*)(&name[0]);
+            CHECKED_CPX_CALL(CPXnewcols, env, lp, 1, &C[i][j], &lb, &ub, &ytype, &yname);
+            map_y[i][j] = map_y[j][i] = current_var_position++;
+        }
+    }
+
+    // Constraints: Flow conservation (every node but 0 consumes one unit)
+    for (int k = 1; k < N; k++) {
+        std::vector<int> idx;
+        std::vector<double> coef;
+        for (int i = 0; i < N; i++) {
+            if (map_x[i][k] >= 0) { idx.push_back(map_x[i][k]); coef.push_back(1.0); }
+            if (map_x[k][i] >= 0) { idx.push_back(map_x[k][i]); coef.push_back(-1.0); }
+        }
+        double rhs = 1.0;
+        char sense = 'E';
+        int matbeg = 0;
+        CHECKED_CPX_CALL(CPXaddrows, env, lp, 0, 1, idx.size(), &rhs, &sense, &matbeg, idx.data(), coef.data(), NULL, NULL);
+    }
+
+    // Constraints: every node has degree 2
+    for (int i = 0; i < N; i++) {
+        std::vector<int> idx;
+        std::vector<double> coef;
+        for (int j = 0; j < N; j++) {
+            if (map_y[i][j] >= 0) { idx.push_back(map_y[i][j]); coef.push_back(1.0); }
+        }
+        double rhs = 2.0;
+        char sense = 'E';
+        int matbeg = 0;
+        CHECKED_CPX_CALL(CPXaddrows, env, lp, 0, 1, idx.size(), &rhs, &sense, &matbeg, idx.data(), coef.data(), NULL, NULL);
+    }
+
+    // Constraints: x_{ij} + x_{ji} - (|N| - 1) y_{ij} <= 0
+    for (int i = 0; i < N; i++) {
+        for (int j = i + 1; j < N; j++) {
+            std::vector<int> idx;
+            std::vector<double> coef;
+            if (map_x[i][j] >= 0) { idx.push_back(map_x[i][j]); coef.push_back(1.0); }
+            if (map_x[j][i] >= 0) { idx.push_back(map_x[j][i]); coef.push_back(1.0); }
+            idx.push_back(map_y[i][j]);
+            coef.push_back(-(N - 1));
+            double rhs = 0.0;
+            char sense = 'L';
+            int matbeg = 0;
+            CHECKED_CPX_CALL(CPXaddrows, env, lp, 0, 1, idx.size(), &rhs, &sense, &matbeg, idx.data(), coef.data(), NULL, NULL);
+        }
+    }
+
+    std::cout << "Finished adding constraints (symmetric model)." << std::endl;
+}
+
+// Command line / config file options
+struct Options {
+    std::string lpFilename = "";        // LP model dump (disabled by default)
+    std::string solFilename = "";       // CPLEX XML solution (disabled by default)
+    std::string tourFilename = "";      // compact tour file (derived from the board name by default)
+    bool writeSol = false;
+    bool symmetric = false;             // undirected edge variables (halves the binaries)
+    int threads = 0;                    // 0: CPLEX decides
+    int parallelMode = CPX_PARALLEL_AUTO;
+    double timeLimit = 0.0;             // seconds, <= 0: no limit
+    double mipGap = -1.0;               // relative gap, < 0: CPLEX default
+    double absGap = -1.0;               // absolute gap, < 0: CPLEX default
+    int nodeFile = -1;                  // node file switch (0-3), < 0: CPLEX default
+    double treeMemLimit = 0.0;          // tree memory limit in MB, <= 0: CPLEX default
+    double workMem = 0.0;               // working memory in MB before node files are used, <= 0: CPLEX default
+    int emphasis = -1;                  // MIP emphasis (0-4), < 0: CPLEX default
+    std::string cacheDir = "";          // instance cache directory (coordinates + distances), empty: disabled
+    DistanceMetric metric = METRIC_EUCLIDEAN;   // must match the tabu search's --metric for comparable values
+};
+
+bool readConfigFile(const std::string& filename, Options& opt);
+
+// Parse one "--name=value" option; returns false if the option is unknown
+bool parseOption(const std::string& arg, Options& opt) {
+    size_t eq = arg.find('=');
+    std::string key = arg.substr(0, eq);
+    std::string value = (eq != std::string::npos) ? arg.substr(eq + 1) : "";
+
+    if (key == "--writeLP") {
+        opt.lpFilename = value;
+    } else if (key == "--writeSol") {
+        opt.writeSol = true;
+        opt.solFilename = value;
+    } else if (key == "--tourFile") {
+        opt.tourFilename = value;
+    } else if (key == "--cacheDir") {
+        opt.cacheDir = value;
+    } else if (key == "--metric") {
+        if (!parseMetric(value, opt.metric)) throw std::runtime_error("unknown metric: " + value);
+    } else if (key == "--symmetric") {
+        // boolean flag: bare, or with an explicit true/false (1/0), e.g. symmetric=false in a config file
+        if (value.empty() || value == "true" || value == "1") opt.symmetric = true;
+        else if (value == "false" || value == "0") opt.symmetric = false;
+        else throw std::runtime_error("--symmetric expects true or false, not: " + value);
+    } else if (key == "--threads") {
+        opt.threads = std::stoi(value);
+    } else if (key == "--parallelMode") {
+        if (value == "deterministic") opt.parallelMode = CPX_PARALLEL_DETERMINISTIC;
+        else if (value == "opportunistic") opt.parallelMode = CPX_PARALLEL_OPPORTUNISTIC;
+        else if (value == "auto") opt.parallelMode = CPX_PARALLEL_AUTO;
+        else throw std::runtime_error("unknown parallel mode: " + value);
+    } else if (key == "--timeLimit") {
+        opt.timeLimit = std::stod(value);
+    } else if (key == "--mipGap") {
+        opt.mipGap = std::stod(value);
+    } else if (key == "--absGap") {
+        opt.absGap = std::stod(value);
+    } else if (key == "--nodeFile") {
+        opt.nodeFile = std::stoi(value);
+    } else if (key == "--treeMemLimit") {
+        opt.treeMemLimit = std::stod(value);
+    } else if (key == "--workMem") {
+        opt.workMem = std::stod(value);
+    } else if (key == "--emphasis") {
+        opt.emphasis = std::stoi(value);
+    } else if (key == "--config") {
+        return readConfigFile(value, opt);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Read options from a config file: one "name=value" per line, '#' starts a comment
+bool readConfigFile(const std::string& filename, Options& opt) {
+    std::ifstream in(filename);
+    if (!in) {
+        std::cerr << "Error opening config file: " << filename << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        line = line.substr(0, line.find('#'));
+        line.erase(0, line.find_first_not_of(" \t"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty()) continue;
+        if (!parseOption("--" + line, opt)) {
+            std::cerr << "Warning: Unknown parameter in " << filename << ": " << line << std::endl;
+        }
+    }
+    return true;
+}
+
+// Set the CPLEX parameters selected on the command line
+void setParameters(Env env, const Options& opt) {
+    CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_EPRHS, 1e-9);
+    if (opt.threads > 0)        CHECKED_CPX_CALL(CPXsetintparam, env, CPX_PARAM_THREADS, opt.threads);
+    CHECKED_CPX_CALL(CPXsetintparam, env, CPX_PARAM_PARALLELMODE, opt.parallelMode);
+    if (opt.timeLimit > 0)      CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_TILIM, opt.timeLimit);
+    if (opt.mipGap >= 0)        CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_EPGAP, opt.mipGap);
+    if (opt.absGap >= 0)        CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_EPAGAP, opt.absGap);
+    if (opt.nodeFile >= 0)      CHECKED_CPX_CALL(CPXsetintparam, env, CPX_PARAM_NODEFILEIND, opt.nodeFile);
+    if (opt.treeMemLimit > 0)   CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_TRELIM, opt.treeMemLimit);
+    if (opt.workMem > 0)        CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_WORKMEM, opt.workMem);
+    if (opt.emphasis >= 0)      CHECKED_CPX_CALL(CPXsetintparam, env, CPX_PARAM_MIPEMPHASIS, opt.emphasis);
+}
+
 int main (int argc, char const *argv[])
 {
     std::string boardFilename = "board.dat";  // Default filename
+    Options opt;
 
     // If a board filename is provided as an argument, use it
     if (argc > 1) {
         boardFilename = argv[1];
     }
 
-    std::vector<Hole> holes = readBoard(boardFilename);
-    std::vector<std::vector<double>> C = computeCostMatrix(holes);
+    try {
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (!parseOption(arg, opt)) {
+                std::cerr << "Warning: Unknown parameter: " << arg << std::endl;
+            }
+        }
+    } catch (std::exception& e) {
+        std::cerr << "Invalid parameter: " << e.what() << std::endl;
+        std::cerr << "usage: ./main_cplex.out board.dat [--threads=N --parallelMode=deterministic|opportunistic|auto "
+                     "--symmetric[=true|false] --metric=euclidean|manhattan|chebyshev|rounded --timeLimit=s --mipGap=r --absGap=a --nodeFile=0-3 --treeMemLimit=MB --workMem=MB --emphasis=0-4 "
+                     "--writeLP=file --writeSol[=file] --tourFile=file --cacheDir=dir --config=file]" << std::endl;
+        return 1;
+    }
+    if (opt.tourFilename.empty()) {
+        opt.tourFilename = getSolutionFilename(boardFilename, ".tour");
+    }
+
+    std::vector<Hole> holes;
+    std::vector<std::vector<double>> C;
+    if (!opt.cacheDir.empty()) {
+        readCachedBoard(boardFilename, opt.cacheDir, opt.metric, holes, C);
+    } else {
+        holes = readBoard(boardFilename);
+        C = computeCostMatrix(holes, opt.metric);
+    }
 
     try {
         DECL_ENV(env);
         DECL_PROB(env, lp);
 
-        setupLP(env, lp, C, holes.size()); // Pass computed cost matrix
+        if (opt.symmetric) {
+            setupSymmetricLP(env, lp, C, holes.size());
+        } else {
+            setupLP(env, lp, C, holes.size()); // Pass computed cost matrix
+        }
 
-        CHECKED_CPX_CALL(CPXwriteprob, env, lp, "debug_model.lp", NULL);
-        CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_EPRHS, 1e-9);
+        if (!opt.lpFilename.empty()) {
+            CHECKED_CPX_CALL(CPXwriteprob, env, lp, opt.lpFilename.c_str(), NULL);
+        }
+        setParameters(env, opt);
 
         std::cout << "Starting optimization..." << std::endl;
         auto start = std::chrono::high_resolution_clock::now();
@@ -255,16 +539,35 @@ int main (int argc, char const *argv[])
         std::chrono::duration<double> elapsed = end - start;
         std::cout << "Solving time: " << elapsed.count() << " seconds" << std::endl;
 
-        double objval;
-        CHECKED_CPX_CALL(CPXgetobjval, env, lp, &objval);
+        // Search statistics (also meaningful when a limit stopped the search)
+        double bestBound = 0.0, gap = -1.0, objval = -1.0;
+        int solStat = CPXgetstat(env, lp);
+        int nodes = CPXgetnodecnt(env, lp);
+        CPXgetbestobjval(env, lp, &bestBound);
+        bool hasSolution = (CPXgetobjval(env, lp, &objval) == 0);
+        if (hasSolution) CPXgetmiprelgap(env, lp, &gap);
+        else objval = -1.0;
+
+        std::cout << "STATUS: " << solStat << std::endl;
+        std::cout << "NODES: " << nodes << std::endl;
+        std::cout << "BEST_BOUND: " << bestBound << std::endl;
+        std::cout << "MIP_GAP: " << gap << std::endl;
         std::cout << "FINAL_VALUE: " << objval << std::endl;
 
-        // Get correct solution filename based on board file name
-        std::string solFilename = getSolutionFilename(boardFilename);
+        if (hasSolution) {
+            // Save the tour (successors read directly from the y variables)
+            std::vector<int> tour = extractTour(env, lp, holes.size());
+            if (writeTourFile(opt.tourFilename, tour, objval)) {
+                std::cout << "Tour saved as: " << opt.tourFilename << std::endl;
+            }
 
-        // Save solution with correct filename
-        CHECKED_CPX_CALL(CPXsolwrite, env, lp, solFilename.c_str());
-        std::cout << "Solution saved as: " << solFilename << std::endl;
+            // Save the full CPLEX solution only on request
+            if (opt.writeSol) {
+                std::string solFilename = opt.solFilename.empty() ? getSolutionFilename(boardFilename) : opt.solFilename;
+                CHECKED_CPX_CALL(CPXsolwrite, env, lp, solFilename.c_str());
+                std::cout << "Solution saved as: " << solFilename << std::endl;
+            }
+        }
 
         CPXfreeprob(env, &lp);
         CPXcloseCPLEX(&env);
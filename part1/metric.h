@@ -0,0 +1,86 @@
+// part1/metric.h
+// Distance metrics between holes as compile-time policies, shared by both solvers (the CPLEX model
+// and the tabu search must solve the same instance).
+#ifndef METRIC_H
+#define METRIC_H
+
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+// Distance metric of an instance (travel time of the drill head)
+enum DistanceMetric {
+    METRIC_EUCLIDEAN,          // straight line (one motor moving along the segment)
+    METRIC_MANHATTAN,          // axes moved one after the other
+    METRIC_CHEBYSHEV,          // axes moved independently at the same speed: the slower axis decides
+    METRIC_ROUNDED_EUCLIDEAN   // TSPLIB EUC_2D: Euclidean rounded to the nearest integer
+};
+
+// Metric policies: distance(dx, dy) for the coordinate differences of two holes.
+// 'tabulated': distance() is costly enough (sqrt) that it is read from a GridDistanceTable when
+// the table is smaller than the matrix; the others are computed directly.
+struct EuclideanMetric {
+    static const bool tabulated = true;
+    static double distance(int dx, int dy) {
+        double x = dx, y = dy;
+        return std::sqrt(x * x + y * y);
+    }
+};
+
+struct ManhattanMetric {
+    static const bool tabulated = false;
+    static double distance(int dx, int dy) { return std::abs(dx) + std::abs(dy); }
+};
+
+struct ChebyshevMetric {
+    static const bool tabulated = false;
+    static double distance(int dx, int dy) { return std::max(std::abs(dx), std::abs(dy)); }
+};
+
+struct RoundedEuclideanMetric {
+    static const bool tabulated = true;
+    static double distance(int dx, int dy) { return (int)(EuclideanMetric::distance(dx, dy) + 0.5); }
+};
+
+// Call f with the policy object of a metric: the only run-time switch, f is instantiated per policy
+template <class F>
+auto withMetric(DistanceMetric metric, F&& f) -> decltype(f(EuclideanMetric())) {
+    switch (metric) {
+        case METRIC_MANHATTAN:         return f(ManhattanMetric());
+        case METRIC_CHEBYSHEV:         return f(ChebyshevMetric());
+        case METRIC_ROUNDED_EUCLIDEAN: return f(RoundedEuclideanMetric());
+        default:                       return f(EuclideanMetric());
+    }
+}
+
+// Distance for a metric chosen at run time (outside hot loops)
+inline double metricDistance(DistanceMetric metric, int dx, int dy) {
+    return withMetric(metric, [dx, dy](auto policy) { return decltype(policy)::distance(dx, dy); });
+}
+
+// Whether a metric chosen at run time is read from a GridDistanceTable (see 'tabulated')
+inline bool metricTabulated(DistanceMetric metric) {
+    return withMetric(metric, [](auto policy) { return decltype(policy)::tabulated; });
+}
+
+// Metric from its command line name (euclidean, manhattan, chebyshev, rounded); false if unknown
+inline bool parseMetric(const std::string& name, DistanceMetric& metric) {
+    if (name == "euclidean") metric = METRIC_EUCLIDEAN;
+    else if (name == "manhattan") metric = METRIC_MANHATTAN;
+    else if (name == "chebyshev") metric = METRIC_CHEBYSHEV;
+    else if (name == "rounded") metric = METRIC_ROUNDED_EUCLIDEAN;
+    else return false;
+    return true;
+}
+
+inline const char* metricName(DistanceMetric metric) {
+    switch (metric) {
+        case METRIC_MANHATTAN:         return "manhattan";
+        case METRIC_CHEBYSHEV:         return "chebyshev";
+        case METRIC_ROUNDED_EUCLIDEAN: return "rounded";
+        default:                       return "euclidean";
+    }
+}
+
+#endif // METRIC_H
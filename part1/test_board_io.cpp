@@ -0,0 +1,75 @@
+// part1/test_board_io.cpp
+// Format detection and parsing of the text board files, including legacy dense grids whose rows do
+// not start on their own line. Exit status 1 on failure.
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+#include "board_io.h"
+
+struct Case {
+    const char* name;
+    const char* content;
+    BoardFormat format;
+    int size;
+    std::vector<std::pair<int, int>> holes;   // (x, y), in any order
+};
+
+static std::vector<std::pair<int, int>> sortedHoles(const BoardFile& board) {
+    std::vector<std::pair<int, int>> holes;
+    for (size_t i = 0; i < board.count(); ++i) holes.push_back({board.holes()[i].x, board.holes()[i].y});
+    std::sort(holes.begin(), holes.end());
+    return holes;
+}
+
+int main() {
+    std::vector<Case> cases = {
+        {"dense, canonical", "3\n0 1 0 \n1 0 0 \n0 0 1 \n", BOARD_DENSE, 3, {{1, 0}, {0, 1}, {2, 2}}},
+        {"dense, first row on the header line", "3 0 1 0\n1 0 0\n0 0 1\n", BOARD_DENSE, 3, {{1, 0}, {0, 1}, {2, 2}}},
+        {"dense, whole grid on one line", "2 1 0 0 1", BOARD_DENSE, 2, {{0, 0}, {1, 1}}},
+        {"dense, one cell on the header line", "1 1\n", BOARD_DENSE, 1, {{0, 0}}},
+        {"dense, first cell 1 (not a count)", "2\n1 0\n0 1\n", BOARD_DENSE, 2, {{0, 0}, {1, 1}}},
+        {"dense, irregular spacing", "2\r\n0\t1\r\n1   1\r\n", BOARD_DENSE, 2, {{1, 0}, {0, 1}, {1, 1}}},
+        {"hole list", "10 3\n0 0\n9 9\n4 2\n", BOARD_SPARSE_TEXT, 10, {{0, 0}, {4, 2}, {9, 9}}},
+        {"hole list, one hole", "5 1\n4 3\n", BOARD_SPARSE_TEXT, 5, {{4, 3}}},
+        {"hole list, no hole", "5 0\n", BOARD_SPARSE_TEXT, 5, {}},
+    };
+
+    const std::string path = "/tmp/test_board_io.tmp";
+    bool ok = true;
+    for (const Case& c : cases) {
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << c.content;
+        }
+        BoardFile board;
+        bool passed = board.open(path) && board.format() == c.format && board.size() == c.size;
+        if (passed) {
+            std::vector<std::pair<int, int>> expected = c.holes;
+            std::sort(expected.begin(), expected.end());
+            passed = sortedHoles(board) == expected;
+        }
+        std::cout << (passed ? "PASS " : "FAIL ") << c.name;
+        if (!board.error().empty()) std::cout << " (" << board.error() << ")";
+        std::cout << std::endl;
+        ok = ok && passed;
+    }
+
+    // malformed files are still rejected
+    const char* malformed[] = {"3 0 1 0\n1 0\n", "4 2\n1 1\n"};
+    for (const char* content : malformed) {
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << content;
+        }
+        BoardFile board;
+        bool passed = !board.open(path);
+        std::cout << (passed ? "PASS " : "FAIL ") << "rejected: " << (passed ? board.error() : "accepted") << std::endl;
+        ok = ok && passed;
+    }
+    std::remove(path.c_str());
+    return ok ? 0 : 1;
+}
@@ -2,6 +2,7 @@ import numpy as np
 import matplotlib.pyplot as plt
 import xml.etree.ElementTree as ET
 import sys
+import os
 
 # Load the board from the given file
 def load_board(board_file):
@@ -40,6 +41,22 @@ def load_solution(solution_file):
 
     return path, objective_value
 
+# Parse a compact tour file (FINAL_SOLUTION / FINAL_VALUE, same format as the tabu solver)
+def load_tour(tour_file):
+    with open(tour_file, 'r') as f:
+        lines = f.readlines()
+
+    tour = []
+    value = None
+    for idx, line in enumerate(lines):
+        if line.startswith("FINAL_SOLUTION"):
+            tour = list(map(int, lines[idx + 1].strip().split()))
+        elif line.startswith("FINAL_VALUE"):
+            value = float(line.strip().split()[1])
+
+    path = [(tour[k], tour[k + 1]) for k in range(len(tour) - 1)]
+    return path, value
+
 # Plot the board and solution path
 def plot_board(board, path, cost=None, title="Drilling Path"):
     holes = extract_hole_positions(board)
@@ -76,16 +93,21 @@ def plot_board(board, path, cost=None, title="Drilling Path"):
 # Main execution
 if __name__ == "__main__":
     board_filename = "board.dat"
-    solution_filename = "drill.sol"
+    solution_filename = "board.tour"
 
     if len(sys.argv) > 1:
         base_name = sys.argv[1]
         board_filename = f"{base_name}.dat"
-        solution_filename = f"{base_name}.sol"
+        solution_filename = f"{base_name}.tour"
+        if not os.path.exists(solution_filename):
+            solution_filename = f"{base_name}.sol"  # full CPLEX solution (--writeSol)
 
     print(f"Loading board from: {board_filename}")
     print(f"Loading solution from: {solution_filename}")
 
     board = load_board(board_filename)
-    path, cost = load_solution(solution_filename)
+    if solution_filename.endswith(".sol"):
+        path, cost = load_solution(solution_filename)
+    else:
+        path, cost = load_tour(solution_filename)
     plot_board(board, path, cost=cost, title=f"Best Solution for {board_filename}")
@@ -0,0 +1,279 @@
+/**
+ * @file BranchAndBound.cpp
+ * @brief exact TSP solver (branch-and-bound on edges with 1-tree Lagrangian bounds)
+ *
+ */
+
+#include "BranchAndBound.h"
+
+#include <thread>
+#include <limits>
+
+static const double BB_EPS = 1e-7;
+
+bool TSPBranchAndBound::solve ( const TSP& tsp , const TSPSolution& initSol , TSPSolution& bestSol )
+{
+  try
+  {
+    int n = tsp.n;
+    bestSequence = initSol.sequence;
+    upperBound = 0.0;
+    for ( uint i = 0 ; i + 1 < bestSequence.size() ; ++i ) {
+      upperBound += tsp.dist(bestSequence[i], bestSequence[i+1]);
+    }
+    nodeCount = 0;
+    aborted = false;
+    optimal = false;
+    activeWorkers = 0;
+    open = decltype(open)();
+
+    if ( n <= 3 ) {                                 // every tour is optimal
+      lowerBound = rootBound = upperBound;
+      optimal = true;
+      bestSol.sequence = bestSequence;
+      return true;
+    }
+
+    start = std::chrono::steady_clock::now();
+    open.push({ {}, std::vector<double>(n, 0.0), -tsp.infinite, 0 });
+
+    std::vector<std::thread> pool;
+    for ( int t = 0 ; t < numThreads ; ++t ) {
+      pool.emplace_back(&TSPBranchAndBound::worker, this, std::cref(tsp));
+    }
+    for ( std::thread& th : pool ) th.join();
+
+    // open nodes carry the bound of their parent, which is valid for the whole subtree
+    while ( !open.empty() && open.top().bound >= upperBound - BB_EPS ) open.pop();
+    optimal = open.empty();
+    lowerBound = optimal ? upperBound : std::min(upperBound, open.top().bound);
+    bestSol.sequence = bestSequence;
+  }
+  catch(std::exception& e)
+  {
+    std::cout << ">>>EXCEPTION: " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TSPBranchAndBound::limitReached ( ) const
+{
+  if ( nodeLimit > 0 && nodeCount >= nodeLimit ) return true;
+  if ( timeLimit > 0 ) {
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    if ( elapsed.count() >= timeLimit ) return true;
+  }
+  return false;
+}
+
+void TSPBranchAndBound::worker ( const TSP& tsp )
+{
+  HeldKarpBound hk(tsp);
+  std::vector<BBNode> children;
+
+  while ( true ) {
+    BBNode node;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv.wait(lock, [this] { return aborted || !open.empty() || activeWorkers == 0; });
+      if ( aborted || open.empty() ) {            // limit hit, or no open node and nobody can create one
+        cv.notify_all();
+        return;
+      }
+      if ( limitReached() ) {
+        aborted = true;
+        cv.notify_all();
+        return;
+      }
+      node = open.top();
+      open.pop();
+      if ( node.bound >= upperBound - BB_EPS ) continue;   // pruned by a newer incumbent
+      ++activeWorkers;
+      ++nodeCount;
+    }
+
+    children.clear();
+    processNode(tsp, hk, node, children);
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      for ( BBNode& child : children ) {
+        if ( child.bound < upperBound - BB_EPS ) open.push(std::move(child));
+      }
+      --activeWorkers;
+    }
+    cv.notify_all();
+  }
+}
+
+bool TSPBranchAndBound::processNode ( const TSP& tsp , const HeldKarpBound& hk , BBNode& node , std::vector<BBNode>& children )
+{
+  int n = tsp.n;
+  std::vector<signed char> edgeState;
+  if ( !buildEdgeStates(n, node.fixes, edgeState) ) return false;
+
+  double ub;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    ub = upperBound;
+  }
+
+  int iterations = childIterations;
+  if ( node.depth == 0 ) iterations = ( rootIterations > 0 ) ? rootIterations : std::max(100, 10 * n);
+
+  OneTree tree;
+  double bound = hk.ascent(edgeState, node.pi, ub, iterations, tree);
+  if ( node.depth == 0 ) rootBound = bound;
+  if ( !tree.feasible ) return false;
+
+  if ( tree.isTour() ) {                          // the relaxation is a tour: optimal for this subtree
+    std::vector<int> sequence;
+    hk.treeToTour(tree, sequence);
+    updateIncumbent(tree.cost, sequence);
+    return true;
+  }
+  if ( bound >= ub - BB_EPS ) return true;
+
+  // branch on the most expensive free tree edge incident to a node of maximum degree
+  int v = 0;
+  for ( int i = 1 ; i < n ; ++i ) {
+    if ( tree.degree[i] > tree.degree[v] ) v = i;
+  }
+  std::vector<int> incident;
+  if ( v == 0 ) {
+    incident.push_back(tree.first0);
+    incident.push_back(tree.second0);
+  } else {
+    if ( v >= 2 ) incident.push_back(tree.parent[v]);
+    if ( v == tree.first0 || v == tree.second0 ) incident.push_back(0);
+    for ( int u = 2 ; u < n ; ++u ) {
+      if ( tree.parent[u] == v ) incident.push_back(u);
+    }
+  }
+  int bi = -1, bj = -1;
+  double bestCost = -1.0;
+  for ( int u : incident ) {
+    if ( edgeState[v * n + u] != EDGE_FREE ) continue;
+    if ( tsp.dist(v, u) > bestCost ) {
+      bestCost = tsp.dist(v, u);
+      bi = v;
+      bj = u;
+    }
+  }
+  if ( bi < 0 ) return false;
+
+  for ( signed char state : { EDGE_OUT , EDGE_IN } ) {
+    BBNode child;
+    child.fixes = node.fixes;
+    child.fixes.push_back({ bi, bj, state });
+    child.pi = node.pi;
+    child.bound = bound;
+    child.depth = node.depth + 1;
+    children.push_back(std::move(child));
+  }
+  return true;
+}
+
+bool TSPBranchAndBound::buildEdgeStates ( int n , const std::vector<EdgeFix>& fixes , std::vector<signed char>& edgeState ) const
+/* Apply the branching decisions and propagate their consequences:
+ * - a node with two forced edges cannot use any other edge
+ * - a node with only two usable edges must use both
+ * - the edge closing a path of forced edges is forbidden (it would create a subtour),
+ *   unless the path already spans all the nodes
+ * Returns false if the decisions cannot be completed to a tour.
+ */
+{
+  auto set = [&]( int i , int j , signed char s ) {
+    edgeState[i * n + j] = s;
+    edgeState[j * n + i] = s;
+  };
+
+  edgeState.assign(n * n, EDGE_FREE);
+  for ( int i = 0 ; i < n ; ++i ) edgeState[i * n + i] = EDGE_OUT;
+  for ( const EdgeFix& f : fixes ) {
+    signed char prev = edgeState[f.i * n + f.j];
+    if ( prev != EDGE_FREE && prev != f.state ) return false;
+    set(f.i, f.j, f.state);
+  }
+
+  std::vector<int> forcedDeg(n);
+  std::vector<int> adj(2 * n);
+  std::vector<bool> visited(n);
+  bool changed = true;
+  while ( changed ) {
+    changed = false;
+
+    // degree rules
+    for ( int i = 0 ; i < n ; ++i ) {
+      int forced = 0, usable = 0;
+      for ( int j = 0 ; j < n ; ++j ) {
+        signed char s = edgeState[i * n + j];
+        if ( s == EDGE_IN ) ++forced;
+        if ( s != EDGE_OUT ) ++usable;
+      }
+      if ( forced > 2 || usable < 2 ) return false;
+      if ( forced == 2 && usable > 2 ) {
+        for ( int j = 0 ; j < n ; ++j ) if ( edgeState[i * n + j] == EDGE_FREE ) set(i, j, EDGE_OUT);
+        changed = true;
+      } else if ( usable == 2 && forced < 2 ) {
+        for ( int j = 0 ; j < n ; ++j ) if ( edgeState[i * n + j] == EDGE_FREE ) set(i, j, EDGE_IN);
+        changed = true;
+      }
+    }
+    if ( changed ) continue;
+
+    // subtour rules on the paths of forced edges
+    for ( int i = 0 ; i < n ; ++i ) {
+      forcedDeg[i] = 0;
+      for ( int j = 0 ; j < n ; ++j ) {
+        if ( edgeState[i * n + j] == EDGE_IN ) adj[2 * i + forcedDeg[i]++] = j;
+      }
+    }
+    std::fill(visited.begin(), visited.end(), false);
+    for ( int a = 0 ; a < n && !changed ; ++a ) {
+      if ( visited[a] || forcedDeg[a] != 1 ) continue;
+      int prev = -1, curr = a, len = 0;
+      visited[a] = true;
+      while ( !( forcedDeg[curr] == 1 && prev >= 0 ) ) {
+        int next = ( adj[2 * curr] != prev ) ? adj[2 * curr] : adj[2 * curr + 1];
+        prev = curr;
+        curr = next;
+        visited[curr] = true;
+        ++len;
+      }
+      signed char closing = edgeState[a * n + curr];
+      if ( len < n - 1 && closing == EDGE_FREE ) {
+        set(a, curr, EDGE_OUT);
+        changed = true;
+      } else if ( len == n - 1 ) {
+        if ( closing == EDGE_OUT ) return false;
+        if ( closing == EDGE_FREE ) {
+          set(a, curr, EDGE_IN);
+          changed = true;
+        }
+      }
+    }
+    if ( changed ) continue;
+
+    // nodes of degree 2 not reached from a path endpoint lie on a forced cycle
+    int onCycle = 0;
+    for ( int i = 0 ; i < n ; ++i ) {
+      if ( !visited[i] && forcedDeg[i] == 2 ) ++onCycle;
+    }
+    if ( onCycle > 0 && onCycle < n ) {
+      // a cycle that does not cover every node is a subtour (a Hamiltonian cycle has onCycle == n)
+      return false;
+    }
+  }
+  return true;
+}
+
+void TSPBranchAndBound::updateIncumbent ( double value , const std::vector<int>& sequence )
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  if ( value < upperBound - BB_EPS ) {
+    upperBound = value;
+    bestSequence = sequence;
+  }
+}
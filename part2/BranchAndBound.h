@@ -0,0 +1,104 @@
+/**
+ * @file BranchAndBound.h
+ * @brief exact TSP solver (branch-and-bound on edges with 1-tree Lagrangian bounds)
+ *
+ */
+
+#ifndef BRANCHANDBOUND_H
+#define BRANCHANDBOUND_H
+
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "TSPSolution.h"
+#include "HeldKarpBound.h"
+
+/**
+ * Branching decision: edge (i,j) fixed to a given state
+ */
+struct EdgeFix {
+  int         i;
+  int         j;
+  signed char state;
+};
+
+/**
+ * Open node of the search tree
+ */
+struct BBNode {
+  std::vector<EdgeFix> fixes;   // branching decisions from the root
+  std::vector<double>  pi;      // penalties of the parent (warm start for the ascent)
+  double               bound;   // bound of the parent
+  int                  depth;
+};
+
+/**
+ * Class that solves a (symmetric) TSP problem to optimality by best-first branch-and-bound.
+ * Bounds come from the Held-Karp 1-tree relaxation, the incumbent is seeded with a heuristic tour
+ * (e.g. the one produced by TSPSolver) and open nodes are explored by a pool of threads.
+ */
+class TSPBranchAndBound
+{
+public:
+  /** Constructor
+  * @param numThreads number of worker threads
+  * @param timeLimit time limit in seconds (<= 0: no limit)
+  * @param nodeLimit maximum number of processed nodes (<= 0: no limit)
+  */
+  TSPBranchAndBound ( int numThreads = 1 , double timeLimit = 0.0 , long nodeLimit = 0 ) :
+    numThreads(std::max(1, numThreads)), timeLimit(timeLimit), nodeLimit(nodeLimit) { }
+
+  /** solve the instance
+  * @param tsp TSP instance
+  * @param initSol heuristic tour used as initial upper bound
+  * @param bestSol output: best tour found (optimal if isOptimal())
+  * @return true if the search terminated without errors
+  */
+  bool solve ( const TSP& tsp , const TSPSolution& initSol , TSPSolution& bestSol );
+
+  double getLowerBound ( ) const { return lowerBound; }
+  double getUpperBound ( ) const { return upperBound; }
+  double getRootBound  ( ) const { return rootBound; }
+  long   getNodeCount  ( ) const { return nodeCount; }
+  bool   isOptimal     ( ) const { return optimal; }
+
+  int rootIterations  = 0;    // subgradient iterations at the root (0: derived from n)
+  int childIterations = 30;   // subgradient iterations at the other nodes
+
+protected:
+  struct NodeOrder {
+    bool operator() ( const BBNode& a , const BBNode& b ) const {
+      if ( a.bound != b.bound ) return a.bound > b.bound;   // best-first ...
+      return a.depth < b.depth;                             // ... diving on ties
+    }
+  };
+
+  void worker ( const TSP& tsp );
+  bool processNode ( const TSP& tsp , const HeldKarpBound& hk , BBNode& node , std::vector<BBNode>& children );
+  bool buildEdgeStates ( int n , const std::vector<EdgeFix>& fixes , std::vector<signed char>& edgeState ) const;
+  bool limitReached ( ) const;
+  void updateIncumbent ( double value , const std::vector<int>& sequence );
+
+  int    numThreads;
+  double timeLimit;
+  long   nodeLimit;
+
+  std::priority_queue<BBNode, std::vector<BBNode>, NodeOrder> open;
+  std::mutex              mtx;
+  std::condition_variable cv;
+  int                     activeWorkers = 0;
+  bool                    aborted = false;
+  std::chrono::steady_clock::time_point start;
+
+  std::vector<int> bestSequence;
+  double upperBound = 0.0;
+  double lowerBound = 0.0;
+  double rootBound  = 0.0;
+  long   nodeCount  = 0;
+  bool   optimal    = false;
+};
+
+#endif /* BRANCHANDBOUND_H */
@@ -0,0 +1,194 @@
+/**
+ * @file Checkpoint.h
+ * @brief binary snapshots of a search state and their asynchronous writer
+ *
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * Append-only byte buffer: plain values are stored with their in-memory representation
+ * (a checkpoint is read back by the same binary, so doubles round-trip bit-exactly)
+ */
+class CheckpointBuffer
+{
+public:
+  std::vector<char> bytes;
+
+  template <typename T>
+  void put ( const T& value ) { putRaw(&value, sizeof(T)); }
+  template <typename T>
+  void putVector ( const std::vector<T>& values ) {
+    put<uint64_t>(values.size());
+    putRaw(values.data(), values.size() * sizeof(T));
+  }
+  void putString ( const std::string& s ) {
+    put<uint64_t>(s.size());
+    putRaw(s.data(), s.size());
+  }
+  void putRaw ( const void* data , size_t size ) {
+    const char* p = static_cast<const char*>(data);
+    bytes.insert(bytes.end(), p, p + size);
+  }
+};
+
+/**
+ * Sequential reader of a CheckpointBuffer (throws std::runtime_error past the end)
+ */
+class CheckpointReader
+{
+public:
+  CheckpointReader ( const char* data , size_t size ) : data(data), size(size), pos(0) { }
+
+  template <typename T>
+  T get ( ) { T value; getRaw(&value, sizeof(T)); return value; }
+  template <typename T>
+  void getVector ( std::vector<T>& values ) {
+    uint64_t count = get<uint64_t>();
+    if ( count > ( size - pos ) / sizeof(T) ) throw std::runtime_error("truncated checkpoint");
+    values.resize(count);
+    getRaw(values.data(), count * sizeof(T));
+  }
+  std::string getString ( ) {
+    uint64_t count = get<uint64_t>();
+    if ( count > size - pos ) throw std::runtime_error("truncated checkpoint");
+    std::string s(data + pos, count);
+    pos += count;
+    return s;
+  }
+  void getRaw ( void* out , size_t bytes ) {
+    if ( bytes > size - pos ) throw std::runtime_error("truncated checkpoint");
+    memcpy(out, data + pos, bytes);
+    pos += bytes;
+  }
+  bool atEnd ( ) const { return pos == size; }
+
+protected:
+  const char* data;
+  size_t      size;
+  size_t      pos;
+};
+
+/**
+ * Background writer of checkpoint files: the search hands over a finished snapshot and goes on;
+ * the file is written to path.tmp, flushed to disk and renamed over path, so a crash at any time
+ * leaves either the previous or the new checkpoint. If snapshots arrive faster than the disk takes
+ * them, only the most recent pending one is written.
+ */
+class CheckpointWriter
+{
+public:
+  explicit CheckpointWriter ( const std::string& path ) : path(path), thread(&CheckpointWriter::run, this) { }
+
+  ~CheckpointWriter ( ) {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stopping = true;
+    }
+    cv.notify_all();
+    thread.join();                  // the last snapshot is written before returning
+  }
+
+  /** queue a snapshot (replacing a pending one not yet started) */
+  void post ( std::vector<char>&& snapshot ) {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      pending.swap(snapshot);
+      hasPending = true;
+    }
+    cv.notify_one();
+  }
+
+  /** block until every posted snapshot is on disk */
+  void flush ( ) {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [this] { return !hasPending && !writing; });
+  }
+
+  /** number of snapshots written so far */
+  int written ( ) {
+    std::lock_guard<std::mutex> lock(mtx);
+    return count;
+  }
+
+  /** read a whole checkpoint file
+  * @return false if the file cannot be read
+  */
+  static bool readFile ( const std::string& path , std::vector<char>& bytes ) {
+    FILE* in = fopen(path.c_str(), "rb");
+    if ( !in ) return false;
+    bytes.clear();
+    char chunk[1 << 16];
+    size_t r;
+    while ( ( r = fread(chunk, 1, sizeof(chunk), in) ) > 0 ) bytes.insert(bytes.end(), chunk, chunk + r);
+    bool ok = !ferror(in);
+    fclose(in);
+    return ok;
+  }
+
+protected:
+  void run ( ) {
+    std::unique_lock<std::mutex> lock(mtx);
+    while ( true ) {
+      cv.wait(lock, [this] { return stopping || hasPending; });
+      if ( !hasPending ) return;
+      std::vector<char> snapshot;
+      snapshot.swap(pending);
+      hasPending = false;
+      writing = true;
+      lock.unlock();
+      writeFile(snapshot);
+      lock.lock();
+      writing = false;
+      ++count;
+      cv.notify_all();
+    }
+  }
+
+  void writeFile ( const std::vector<char>& snapshot ) {
+    std::string tmp = path + ".tmp";
+    int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if ( fd < 0 ) {
+      perror(tmp.c_str());
+      return;
+    }
+    size_t done = 0;
+    bool ok = true;
+    while ( ok && done < snapshot.size() ) {
+      ssize_t w = write(fd, snapshot.data() + done, snapshot.size() - done);
+      ok = w > 0;
+      if ( ok ) done += w;
+    }
+    ok = ok && fsync(fd) == 0;
+    ok = ( close(fd) == 0 ) && ok;
+    if ( !ok || rename(tmp.c_str(), path.c_str()) != 0 ) {
+      perror(path.c_str());
+      unlink(tmp.c_str());
+    }
+  }
+
+  std::string             path;
+  std::vector<char>       pending;
+  bool                    hasPending = false;
+  bool                    writing = false;
+  bool                    stopping = false;
+  int                     count = 0;
+  std::mutex              mtx;
+  std::condition_variable cv;
+  std::thread             thread;    // last: started once the other members exist
+};
+
+#endif /* CHECKPOINT_H */
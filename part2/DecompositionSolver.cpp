@@ -0,0 +1,231 @@
+/**
+ * @file DecompositionSolver.cpp
+ * @brief spatial decomposition for very large boards: Karp partition, parallel cluster tours,
+ *        stitching and POPMUSIC-style windowed re-optimization
+ *
+ */
+
+#include "DecompositionSolver.h"
+#include "WorkStealingPool.h"
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+static double distance ( DistanceMetric metric , const std::pair<int, int>& a , const std::pair<int, int>& b )
+{
+  return metricDistance(metric, a.first - b.first, a.second - b.second);
+}
+
+/** symmetric TSP instance over a subset of the holes (a subproblem) */
+static void buildSubInstance ( const std::vector<std::pair<int, int>>& holes , const std::vector<int>& ids , DistanceMetric metric , TSP& sub )
+{
+  sub.holes.resize(ids.size());
+  for ( size_t k = 0 ; k < ids.size() ; ++k ) sub.holes[k] = holes[ids[k]];
+  sub.n = ids.size();
+  sub.metric = metric;
+  sub.computeCostMatrix(true);
+}
+
+double DecompositionSolver::tourLength ( const std::vector<std::pair<int, int>>& holes , const std::vector<int>& tour , DistanceMetric metric )
+{
+  double total = 0.0;
+  for ( size_t k = 0 ; k < tour.size() ; ++k ) total += distance(metric, holes[tour[k]], holes[tour[( k + 1 ) % tour.size()]]);
+  return total;
+}
+
+void DecompositionSolver::partition ( const std::vector<std::pair<int, int>>& holes , std::vector<int>& ids , size_t begin , size_t end ,
+                                      std::vector<std::vector<int>>& leaves ) const
+{
+  if ( end - begin <= (size_t)std::max(3, params.clusterSize) ) {
+    leaves.push_back(std::vector<int>(ids.begin() + begin, ids.begin() + end));
+    return;
+  }
+  int minX = holes[ids[begin]].first, maxX = minX, minY = holes[ids[begin]].second, maxY = minY;
+  for ( size_t k = begin ; k < end ; ++k ) {
+    minX = std::min(minX, holes[ids[k]].first);  maxX = std::max(maxX, holes[ids[k]].first);
+    minY = std::min(minY, holes[ids[k]].second); maxY = std::max(maxY, holes[ids[k]].second);
+  }
+  bool byX = ( maxX - minX ) >= ( maxY - minY );
+  size_t mid = begin + ( end - begin ) / 2;
+  std::nth_element(ids.begin() + begin, ids.begin() + mid, ids.begin() + end, [&]( int a , int b ) {
+    return byX ? holes[a] < holes[b] : std::make_pair(holes[a].second, holes[a].first) < std::make_pair(holes[b].second, holes[b].first);
+  });
+  partition(holes, ids, begin, mid, leaves);
+  partition(holes, ids, mid, end, leaves);
+}
+
+std::vector<int> DecompositionSolver::clusterTour ( const std::vector<std::pair<int, int>>& holes , const std::vector<int>& ids , unsigned int seed ) const
+{
+  if ( ids.size() < 4 ) return ids;                 // every order of 3 holes is optimal
+  TSP sub;
+  buildSubInstance(holes, ids, params.metric, sub);
+  TSPSolver solver("", params.alpha, params.beta, params.decayFactor, params.lambda);
+  solver.setVerbose(false);
+  solver.setSeed(seed);
+  TSPSolution init(sub), best(sub);
+  solver.initRnd(init);
+  solver.solve(sub, init, 0, params.clusterIterations, best);
+  std::vector<int> tour(ids.size());
+  for ( size_t k = 0 ; k < ids.size() ; ++k ) tour[k] = ids[best.sequence[k]];
+  return tour;
+}
+
+bool DecompositionSolver::optimizeWindow ( const std::vector<std::pair<int, int>>& holes , int* path , int length , unsigned int seed ) const
+{
+  if ( length < 5 ) return false;
+  // node 0: dummy joined to both endpoints at no cost and to every other node at a cost M larger
+  // than any path through the window, so good tours are the paths from path[0] to path[length-1]
+  TSP sub;
+  sub.n = length + 1;
+  sub.symmetric = true;
+  sub.symCost.resize(sub.n, 0.0);
+  double before = 0.0, diagonal = 0.0;
+  for ( int k = 0 ; k + 1 < length ; ++k ) before += distance(params.metric, holes[path[k]], holes[path[k + 1]]);
+  for ( int i = 0 ; i < length ; ++i ) {
+    for ( int j = 0 ; j < i ; ++j ) {
+      double d = distance(params.metric, holes[path[i]], holes[path[j]]);
+      sub.symCost(i + 1, j + 1) = d;
+      diagonal = std::max(diagonal, d);
+    }
+  }
+  double M = diagonal * ( length + 1 ) + 1.0;
+  for ( int i = 2 ; i < length ; ++i ) sub.symCost(0, i) = M;
+  sub.infinite = 0.0;
+  for ( int i = 0 ; i < sub.n ; ++i ) for ( int j = 0 ; j < i ; ++j ) sub.infinite += 2 * sub.symCost(i, j);
+  sub.infinite *= 2;
+
+  TSPSolver solver("", params.alpha, params.beta, params.decayFactor, params.lambda);
+  solver.setVerbose(false);
+  solver.setSeed(seed);
+  TSPSolution init(sub);                            // <dummy, path[0], ..., path[length-1], dummy>
+  solver.start(sub, init);
+  solver.resume(sub, params.windowIterations);
+  const std::vector<int>& seq = solver.getIncumbent().sequence;
+
+  // valid only if the dummy still sits between the two endpoints
+  bool forward = ( seq[1] == 1 && seq[length] == length );
+  bool backward = ( seq[1] == length && seq[length] == 1 );
+  if ( !forward && !backward ) return false;
+  double after = 0.0;
+  for ( int k = 1 ; k < length ; ++k ) after += sub.symCost(seq[k], seq[k + 1]);
+  if ( after >= before - 1e-9 ) return false;
+
+  std::vector<int> improved(length);
+  for ( int k = 0 ; k < length ; ++k ) improved[k] = path[seq[forward ? k + 1 : length - k] - 1];
+  std::copy(improved.begin(), improved.end(), path);
+  return true;
+}
+
+double DecompositionSolver::solve ( const std::vector<std::pair<int, int>>& holes , std::vector<int>& tour )
+{
+  const int n = holes.size();
+  tour.clear();
+  windowsImproved = 0;
+  if ( n == 0 ) return 0.0;
+
+  // 1. Karp partition
+  std::vector<int> ids(n);
+  for ( int i = 0 ; i < n ; ++i ) ids[i] = i;
+  std::vector<std::vector<int>> leaves;
+  partition(holes, ids, 0, n, leaves);
+  clusters = leaves.size();
+
+  // 2. clusters along the Hilbert curve of their centroids
+  uint32_t side = hilbertSide(holes);
+  std::vector<std::pair<uint64_t, int>> order(leaves.size());
+  for ( size_t c = 0 ; c < leaves.size() ; ++c ) {
+    double cx = 0.0, cy = 0.0;
+    for ( int id : leaves[c] ) { cx += holes[id].first; cy += holes[id].second; }
+    cx /= leaves[c].size();
+    cy /= leaves[c].size();
+    order[c] = std::make_pair(hilbertIndex(side, (uint32_t)cx, (uint32_t)cy), (int)c);
+  }
+  std::sort(order.begin(), order.end());
+
+  WorkStealingPool pool(std::max(1, params.threads));
+  std::vector<std::vector<int>> cycles(leaves.size());
+  for ( size_t c = 0 ; c < leaves.size() ; ++c ) {
+    pool.submit([&, c] { cycles[c] = clusterTour(holes, leaves[c], params.seed + 7919u * c); });
+  }
+  pool.wait();
+
+  // 3. stitching: open each cluster cycle at edge (u, v), entering at u and leaving at v, where the
+  //    entry is closest to the current end of the path and the exit closest to the next cluster
+  for ( size_t o = 0 ; o < order.size() ; ++o ) {
+    const std::vector<int>& cycle = cycles[order[o].second];
+    int m = cycle.size();
+    std::pair<int, int> next(0, 0);                 // centroid of the next cluster (nearest grid point)
+    bool hasNext = o + 1 < order.size();
+    if ( hasNext ) {
+      double nx = 0.0, ny = 0.0;
+      for ( int id : leaves[order[o + 1].second] ) { nx += holes[id].first; ny += holes[id].second; }
+      next.first = (int)std::lround(nx / leaves[order[o + 1].second].size());
+      next.second = (int)std::lround(ny / leaves[order[o + 1].second].size());
+    }
+    auto toNext = [&]( int id ) {
+      if ( !hasNext ) return 0.0;
+      return distance(params.metric, holes[id], next);
+    };
+    if ( tour.empty() ) {
+      // first cluster: enter anywhere, pick the exit only
+      double best = 1e300;
+      int bestK = 0, bestDir = 1;
+      for ( int k = 0 ; k < m ; ++k ) {
+        for ( int dir = -1 ; dir <= 1 ; dir += 2 ) {
+          int u = cycle[k], v = cycle[( k + dir + m ) % m];
+          double cost = toNext(v) - distance(params.metric, holes[u], holes[v]);
+          if ( cost < best ) { best = cost; bestK = k; bestDir = dir; }
+        }
+      }
+      for ( int s = 0 ; s < m ; ++s ) tour.push_back(cycle[( bestK - bestDir * s + 2 * m ) % m]);
+      continue;
+    }
+    const std::pair<int, int>& end = holes[tour.back()];
+    double best = 1e300;
+    int bestK = 0, bestDir = 1;
+    for ( int k = 0 ; k < m ; ++k ) {
+      for ( int dir = -1 ; dir <= 1 ; dir += 2 ) {
+        int u = cycle[k], v = cycle[( k + dir + m ) % m];   // enter at u, remove (u, v), leave at v
+        double cost = distance(params.metric, end, holes[u]) - distance(params.metric, holes[u], holes[v]) + toNext(v);
+        if ( cost < best ) { best = cost; bestK = k; bestDir = dir; }
+      }
+    }
+    for ( int s = 0 ; s < m ; ++s ) tour.push_back(cycle[( bestK - bestDir * s + 2 * m ) % m]);
+  }
+  stitchedValue = tourLength(holes, tour, params.metric);
+
+  // 4. windowed re-optimization (disjoint windows in parallel, shifted by half a window every pass);
+  //    the windows tile the cyclic tour from the offset on, so the last one may wrap around the
+  //    closing edge (n-1, 0) and is then optimized in a copy
+  int window = std::max(5, params.windowSize);
+  for ( int pass = 0 ; pass < params.passes && n > window ; ++pass ) {
+    int offset = ( pass % 2 ) * ( window / 2 );
+    std::atomic<long> improved(0);
+    for ( int begin = offset ; begin < offset + n ; begin += window ) {
+      int start = begin % n;
+      int length = std::min(window, offset + n - begin);
+      pool.submit([&, start, length, pass] {
+        unsigned int seed = params.seed + 104729u * pass + start;
+        if ( start + length <= n ) {
+          if ( optimizeWindow(holes, tour.data() + start, length, seed) ) ++improved;
+          return;
+        }
+        std::vector<int> path(length);
+        for ( int k = 0 ; k < length ; ++k ) path[k] = tour[( start + k ) % n];
+        if ( optimizeWindow(holes, path.data(), length, seed) ) {
+          for ( int k = 0 ; k < length ; ++k ) tour[( start + k ) % n] = path[k];
+          ++improved;
+        }
+      });
+    }
+    pool.wait();
+    windowsImproved += improved;
+    if ( improved == 0 && pass > 0 ) break;
+  }
+
+  // start at hole 0
+  std::rotate(tour.begin(), std::find(tour.begin(), tour.end(), 0), tour.end());
+  return tourLength(holes, tour, params.metric);
+}
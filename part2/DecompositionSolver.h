@@ -0,0 +1,89 @@
+/**
+ * @file DecompositionSolver.h
+ * @brief spatial decomposition for very large boards: Karp partition, parallel cluster tours,
+ *        stitching and POPMUSIC-style windowed re-optimization
+ *
+ */
+
+#ifndef DECOMPOSITIONSOLVER_H
+#define DECOMPOSITIONSOLVER_H
+
+#include <vector>
+#include <utility>
+
+#include "TSPSolver.h"
+
+/**
+ * Parameters of the decomposition solver
+ */
+struct DecompositionParams {
+  int    clusterSize = 200;        // maximum holes per cluster (leaf of the Karp partition)
+  int    clusterIterations = 300;  // tabu iterations per cluster tour
+  int    windowSize = 100;         // tour positions re-optimized together
+  int    windowIterations = 100;   // tabu iterations per window
+  int    passes = 4;               // re-optimization passes (alternately shifted by half a window)
+  int    threads = 1;
+  unsigned int seed = 1;
+  double alpha = 0.75;             // tabu parameters of every subproblem
+  double beta = 0.5;
+  double decayFactor = 0.9;
+  double lambda = 0.01;
+  DistanceMetric metric = METRIC_EUCLIDEAN;
+};
+
+/**
+ * Solver that never builds the n x n matrix: only subproblems of a few hundred holes get a TSP
+ * instance (and fit in cache), so memory is O(n) and the work is O(n) per pass.
+ * 1. Karp partition: the holes are split recursively at the median of the longer side of their
+ *    bounding box until at most clusterSize holes are left
+ * 2. the clusters are ordered along a Hilbert curve (of their centroids) and their tours are
+ *    solved in parallel with TSPSolver
+ * 3. stitching: cluster after cluster, each tour is opened at the edge that best connects it to
+ *    the end of the path built so far, and appended to the global tour
+ * 4. POPMUSIC-style improvement: windows of windowSize consecutive tour positions are re-optimized
+ *    as paths with fixed endpoints (a dummy node joins the endpoints, so TSPSolver's closed tours
+ *    apply); the windows of a pass are disjoint and solved in parallel, consecutive passes are
+ *    shifted by half a window so that every boundary gets re-optimized
+ */
+class DecompositionSolver
+{
+public:
+  DecompositionSolver ( const DecompositionParams& params ) : params(params) { }
+
+  /** solve a board given by its hole coordinates
+  * @param holes (x, y) of every hole
+  * @param tour output: permutation of the holes starting with hole 0 (no closing node)
+  * @return tour length
+  */
+  double solve ( const std::vector<std::pair<int, int>>& holes , std::vector<int>& tour );
+
+  /** length of a closed tour over coordinates */
+  static double tourLength ( const std::vector<std::pair<int, int>>& holes , const std::vector<int>& tour ,
+                             DistanceMetric metric = METRIC_EUCLIDEAN );
+
+  /** re-optimize a path with fixed endpoints by tabu search (windowIterations iterations; a dummy
+  * node joins the endpoints, so that TSPSolver's closed tours apply)
+  * @param holes (x, y) of every hole
+  * @param path hole ids, rewritten in place if a shorter path from path[0] to path[length - 1] is found
+  * @param length holes in the path (paths of less than 5 holes are left as they are)
+  * @param seed solver seed
+  * @return true if the path was improved
+  */
+  bool optimizeWindow ( const std::vector<std::pair<int, int>>& holes , int* path , int length , unsigned int seed ) const;
+
+  int    getClusters ( ) const { return clusters; }
+  double getStitchedValue ( ) const { return stitchedValue; }
+  long   getWindowsImproved ( ) const { return windowsImproved; }
+
+protected:
+  void partition ( const std::vector<std::pair<int, int>>& holes , std::vector<int>& ids , size_t begin , size_t end ,
+                   std::vector<std::vector<int>>& leaves ) const;
+  std::vector<int> clusterTour ( const std::vector<std::pair<int, int>>& holes , const std::vector<int>& ids , unsigned int seed ) const;
+
+  DecompositionParams params;
+  int    clusters = 0;
+  double stitchedValue = 0.0;
+  long   windowsImproved = 0;
+};
+
+#endif /* DECOMPOSITIONSOLVER_H */
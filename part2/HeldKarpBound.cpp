@@ -0,0 +1,163 @@
+/**
+ * @file HeldKarpBound.cpp
+ * @brief 1-tree Lagrangian (Held-Karp) lower bound for the symmetric TSP
+ *
+ */
+
+#include "HeldKarpBound.h"
+
+#include <limits>
+
+bool HeldKarpBound::oneTree ( const std::vector<signed char>& edgeState , const std::vector<double>& pi , OneTree& tree ) const
+{
+  const double INF = std::numeric_limits<double>::infinity();
+  bool constrained = !edgeState.empty();
+  auto state = [&]( int i , int j ) -> signed char { return constrained ? edgeState[i * n + j] : EDGE_FREE; };
+
+  tree.parent.assign(n, -1);
+  tree.degree.assign(n, 0);
+  tree.first0 = tree.second0 = -1;
+  tree.cost = tree.bound = 0.0;
+  tree.feasible = false;
+
+  // Prim on nodes 1..n-1; forced edges always win over free ones
+  std::vector<double> key(n, INF);
+  std::vector<bool>   keyForced(n, false);
+  std::vector<bool>   inTree(n, false);
+  inTree[0] = true;
+  int v = 1;
+  inTree[v] = true;
+  for ( int added = 2 ; added < n ; ++added ) {
+    for ( int u = 1 ; u < n ; ++u ) {
+      if ( inTree[u] ) continue;
+      signed char s = state(v, u);
+      if ( s == EDGE_OUT ) continue;
+      double w = tsp.dist(v, u) + pi[v] + pi[u];
+      bool forced = ( s == EDGE_IN );
+      if ( ( forced && !keyForced[u] ) || ( forced == keyForced[u] && w < key[u] ) ) {
+        key[u] = w;
+        keyForced[u] = forced;
+        tree.parent[u] = v;
+      }
+    }
+    int next = -1;
+    for ( int u = 1 ; u < n ; ++u ) {
+      if ( inTree[u] || key[u] == INF ) continue;
+      if ( next < 0 || ( keyForced[u] && !keyForced[next] ) || ( keyForced[u] == keyForced[next] && key[u] < key[next] ) ) {
+        next = u;
+      }
+    }
+    if ( next < 0 ) return false;   // excluded edges disconnect the graph
+    inTree[next] = true;
+    int p = tree.parent[next];
+    tree.degree[next]++;
+    tree.degree[p]++;
+    tree.cost  += tsp.dist(p, next);
+    tree.bound += key[next];
+    v = next;
+  }
+
+  // two edges incident to node 0: forced ones first, then the cheapest free ones
+  for ( int pass = 0 ; pass < 2 ; ++pass ) {
+    int    best = -1;
+    bool   bestForced = false;
+    double bestW = INF;
+    for ( int u = 1 ; u < n ; ++u ) {
+      if ( u == tree.first0 ) continue;
+      signed char s = state(0, u);
+      if ( s == EDGE_OUT ) continue;
+      double w = tsp.dist(0, u) + pi[0] + pi[u];
+      bool forced = ( s == EDGE_IN );
+      if ( best < 0 || ( forced && !bestForced ) || ( forced == bestForced && w < bestW ) ) {
+        best = u;
+        bestW = w;
+        bestForced = forced;
+      }
+    }
+    if ( best < 0 ) return false;
+    if ( pass == 0 ) tree.first0 = best; else tree.second0 = best;
+    tree.degree[0]++;
+    tree.degree[best]++;
+    tree.cost  += tsp.dist(0, best);
+    tree.bound += bestW;
+  }
+
+  for ( int i = 0 ; i < n ; ++i ) tree.bound -= 2 * pi[i];
+  tree.feasible = true;
+  return true;
+}
+
+double HeldKarpBound::ascent ( const std::vector<signed char>& edgeState , std::vector<double>& pi , double upperBound , int maxIter , OneTree& tree ) const
+{
+  const double eps = 1e-9;
+  if ( (int)pi.size() != n ) pi.assign(n, 0.0);
+
+  std::vector<double> currPi(pi);
+  OneTree curr;
+  double bestBound = -tsp.infinite;
+  double step = 2.0;
+  int period = std::max(5, std::min(n, maxIter / 4));
+  int noImprove = 0;
+
+  for ( int iter = 0 ; iter < std::max(1, maxIter) ; ++iter ) {
+    if ( !oneTree(edgeState, currPi, curr) ) {
+      tree.feasible = false;
+      return tsp.infinite;
+    }
+
+    if ( curr.bound > bestBound + eps ) {
+      bestBound = curr.bound;
+      pi = currPi;
+      tree = curr;
+      noImprove = 0;
+    } else if ( ++noImprove >= period ) {
+      step /= 2;
+      noImprove = 0;
+    }
+
+    if ( curr.isTour() ) {                                // the 1-tree is a tour: bound is exact
+      bestBound = std::max(bestBound, curr.bound);
+      pi = currPi;
+      tree = curr;                                        // kept even without a bound improvement
+      break;
+    }
+    if ( bestBound >= upperBound - eps ) break;           // node can be pruned
+    if ( step < 1e-6 ) break;
+
+    double norm = 0.0;
+    for ( int i = 0 ; i < n ; ++i ) {
+      double g = curr.degree[i] - 2;
+      norm += g * g;
+    }
+    double gap = ( upperBound < tsp.infinite ) ? upperBound - curr.bound : 0.05 * std::abs(curr.cost) + 1.0;
+    double t = step * gap / norm;
+    for ( int i = 0 ; i < n ; ++i ) {
+      currPi[i] += t * ( curr.degree[i] - 2 );
+    }
+  }
+  return bestBound;
+}
+
+void HeldKarpBound::treeToTour ( const OneTree& tree , std::vector<int>& sequence ) const
+{
+  std::vector<std::vector<int>> adj(n);
+  for ( int v = 2 ; v < n ; ++v ) {
+    adj[v].push_back(tree.parent[v]);
+    adj[tree.parent[v]].push_back(v);
+  }
+  adj[0].push_back(tree.first0);
+  adj[tree.first0].push_back(0);
+  adj[0].push_back(tree.second0);
+  adj[tree.second0].push_back(0);
+
+  sequence.clear();
+  sequence.reserve(n + 1);
+  int prev = -1, curr = 0;
+  for ( int k = 0 ; k < n ; ++k ) {
+    sequence.push_back(curr);
+    int next = ( adj[curr][0] != prev ) ? adj[curr][0] : adj[curr][1];
+    prev = curr;
+    curr = next;
+  }
+  sequence.push_back(0);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file HeldKarpBound.h
+ * @brief 1-tree Lagrangian (Held-Karp) lower bound for the symmetric TSP
+ *
+ */
+
+#ifndef HELDKARPBOUND_H
+#define HELDKARPBOUND_H
+
+#include <vector>
+
+#include "TSP.h"
+
+/**
+ * State of an edge inside a branch-and-bound node
+ */
+enum EdgeState : signed char {
+  EDGE_FREE  = 0,
+  EDGE_IN    = 1,   // edge forced into the tour
+  EDGE_OUT   = -1   // edge forbidden
+};
+
+/**
+ * Minimum 1-tree: spanning tree on nodes 1..n-1 plus the two cheapest edges incident to node 0
+ * (each tree node stores its parent; node 0 stores its two neighbours in first0 / second0)
+ */
+struct OneTree {
+  std::vector<int> parent;   // parent[v] for v >= 2 (node 1 is the root of the spanning tree)
+  std::vector<int> degree;   // degree of every node in the 1-tree
+  int    first0  = -1;
+  int    second0 = -1;
+  double cost    = 0.0;      // cost of the 1-tree w.r.t. the original distances
+  double bound   = 0.0;      // Lagrangian value: cost with penalties - 2 * sum(pi)
+  bool   feasible = false;   // false if the edge states do not admit any 1-tree
+
+  bool isTour ( ) const {
+    for ( int d : degree ) if ( d != 2 ) return false;
+    return !degree.empty();
+  }
+};
+
+/**
+ * Class that computes 1-tree lower bounds with node penalties (Held-Karp) and improves them by
+ * subgradient optimization.
+ * Distances are assumed symmetric (cost[i][j] == cost[j][i]), as for the drilling boards.
+ */
+class HeldKarpBound
+{
+public:
+  HeldKarpBound ( const TSP& tsp ) : tsp(tsp), n(tsp.n) { }
+
+  /** compute the minimum 1-tree for fixed penalties
+  * @param edgeState n*n edge states (empty vector: all edges free)
+  * @param pi node penalties
+  * @param tree output 1-tree
+  * @return true if a 1-tree exists
+  */
+  bool oneTree ( const std::vector<signed char>& edgeState , const std::vector<double>& pi , OneTree& tree ) const;
+
+  /** subgradient ascent on the node penalties
+  * @param edgeState n*n edge states (empty vector: all edges free)
+  * @param pi node penalties (in: starting point, out: best penalties found)
+  * @param upperBound value of a known tour (used for the step size and for early stop)
+  * @param maxIter number of subgradient iterations
+  * @param tree output: 1-tree attaining the best bound
+  * @return best Lagrangian bound found (tsp.infinite if the node is infeasible)
+  */
+  double ascent ( const std::vector<signed char>& edgeState , std::vector<double>& pi , double upperBound , int maxIter , OneTree& tree ) const;
+
+  /** extract the tour encoded by a 1-tree whose nodes all have degree 2
+  * @param tree 1-tree (must satisfy tree.isTour())
+  * @param sequence output sequence <0, ..., 0>
+  */
+  void treeToTour ( const OneTree& tree , std::vector<int>& sequence ) const;
+
+protected:
+  const TSP& tsp;
+  int        n;
+};
+
+#endif /* HELDKARPBOUND_H */
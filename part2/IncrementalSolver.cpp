@@ -0,0 +1,201 @@
+/**
+ * @file IncrementalSolver.cpp
+ * @brief re-optimization of a previous tour after a board edit (holes added or removed)
+ *
+ */
+
+#include "IncrementalSolver.h"
+#include "DecompositionSolver.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <deque>
+
+static uint64_t coordinateKey ( const std::pair<int, int>& hole )
+{
+  return ( (uint64_t)(uint32_t)hole.first << 32 ) | (uint32_t)hole.second;
+}
+
+double IncrementalSolver::distance ( int a , int b ) const
+{
+  const std::vector<std::pair<int, int>>& h = *holes;
+  return metricDistance(params.metric, h[a].first - h[b].first, h[a].second - h[b].second);
+}
+
+void IncrementalSolver::twoOpt ( const SpatialIndex& index , std::vector<int>& tour , const std::vector<int>& start )
+{
+  const int n = tour.size();
+  if ( n < 5 ) return;
+  std::vector<int> pos(holes->size(), -1);
+  for ( int p = 0 ; p < n ; ++p ) pos[tour[p]] = p;
+  auto succ = [&]( int u ) { return tour[( pos[u] + 1 ) % n]; };
+  auto pred = [&]( int u ) { return tour[( pos[u] + n - 1 ) % n]; };
+  // reverse the tour positions from p to q (going forward); the complement is reversed instead when
+  // shorter (same cyclic tour, read backwards)
+  auto reverse = [&]( int p , int q ) {
+    int length = ( q - p + n ) % n + 1;
+    if ( 2 * length > n ) {
+      int first = ( q + 1 ) % n;
+      q = ( p + n - 1 ) % n;
+      p = first;
+      length = n - length;
+    }
+    for ( int s = 0 ; s < length / 2 ; ++s ) {
+      std::swap(tour[p], tour[q]);
+      pos[tour[p]] = p;
+      pos[tour[q]] = q;
+      p = ( p + 1 ) % n;
+      q = ( q + n - 1 ) % n;
+    }
+  };
+
+  std::unordered_map<int, std::vector<int>> near;  // neighbour lists of the nodes examined only
+  std::deque<int> queue;
+  std::vector<char> queued(holes->size(), 0);
+  auto push = [&]( int u ) { if ( !queued[u] ) { queued[u] = 1; queue.push_back(u); } };
+  for ( int u : start ) push(u);
+
+  while ( !queue.empty() ) {
+    int a = queue.front();
+    queue.pop_front();
+    queued[a] = 0;
+    auto found = near.find(a);
+    if ( found == near.end() ) {
+      found = near.emplace(a, std::vector<int>()).first;
+      index.kNearest(a, params.neighbours, found->second, params.metric);
+    }
+    bool improved = false;
+    for ( int forward = 1 ; forward >= 0 && !improved ; --forward ) {
+      int b = forward ? succ(a) : pred(a);
+      double ab = distance(a, b);
+      for ( int c : found->second ) {
+        double ac = distance(a, c);
+        if ( ac >= ab ) break;                      // neighbours by increasing distance (in the metric): no gain left
+        int d = forward ? succ(c) : pred(c);
+        if ( c == b || d == a ) continue;
+        double delta = ac + distance(b, d) - ab - distance(c, d);
+        if ( delta > -1e-9 ) continue;
+        // forward: (a b ... c d) -> (a c ... b d); backward: (b a ... d c) -> (b d ... a c)
+        if ( forward ) reverse(pos[b], pos[c]);
+        else reverse(pos[a], pos[d]);
+        ++twoOptMoves;
+        push(a); push(b); push(c); push(d);
+        improved = true;
+        break;
+      }
+    }
+  }
+}
+
+double IncrementalSolver::solve ( const std::vector<std::pair<int, int>>& oldHoles , const std::vector<int>& oldTour ,
+                                  const std::vector<std::pair<int, int>>& newHoles , std::vector<int>& tour )
+{
+  holes = &newHoles;
+  const int n = newHoles.size();
+  tour.clear();
+  kept = removed = inserted = 0;
+  twoOptMoves = windowsImproved = 0;
+  if ( n == 0 ) return 0.0;
+
+  // 1. match the boards by coordinates; the previous order of the remaining holes is kept
+  std::unordered_map<uint64_t, int> idOf;
+  idOf.reserve(n);
+  for ( int i = 0 ; i < n ; ++i ) idOf.emplace(coordinateKey(newHoles[i]), i);
+  std::vector<char> inTour(n, 0);
+  std::vector<int> edited;                          // tour holes next to an edit
+  size_t length = oldTour.size();
+  if ( length > 1 && oldTour.front() == oldTour.back() ) --length;   // closing node
+  bool gap = false;
+  for ( size_t k = 0 ; k < length ; ++k ) {
+    int old = oldTour[k];
+    auto found = ( old >= 0 && old < (int)oldHoles.size() ) ? idOf.find(coordinateKey(oldHoles[old])) : idOf.end();
+    if ( found == idOf.end() || inTour[found->second] ) {
+      ++removed;
+      if ( !gap && !tour.empty() ) edited.push_back(tour.back());
+      gap = true;
+      continue;
+    }
+    tour.push_back(found->second);
+    inTour[found->second] = 1;
+    if ( gap ) edited.push_back(found->second);
+    gap = false;
+  }
+  if ( gap && !tour.empty() ) edited.push_back(tour.front());   // removal run wrapping around
+  kept = tour.size();
+
+  // 2. cheapest insertion of the new holes among the edges of their nearest tour holes
+  SpatialIndex index(newHoles);
+  for ( int i = 0 ; i < n ; ++i ) if ( !inTour[i] ) index.remove(i);
+  std::vector<int> next(n, -1), prev(n, -1);
+  for ( size_t k = 0 ; k < tour.size() ; ++k ) {
+    next[tour[k]] = tour[( k + 1 ) % tour.size()];
+    prev[tour[( k + 1 ) % tour.size()]] = tour[k];
+  }
+  int anchor = tour.empty() ? -1 : tour[0];
+  std::vector<int> near;
+  for ( int h = 0 ; h < n ; ++h ) {
+    if ( inTour[h] ) continue;
+    if ( anchor < 0 ) {                             // nothing left of the previous tour
+      next[h] = prev[h] = h;
+      anchor = h;
+    } else {
+      index.kNearest(h, params.neighbours, near, params.metric);
+      double best = 1e300;
+      int bestU = anchor;
+      for ( int c : near ) {
+        for ( int u : { prev[c], c } ) {            // edges (prev c, c) and (c, next c)
+          double delta = distance(u, h) + distance(h, next[u]) - distance(u, next[u]);
+          if ( delta < best ) { best = delta; bestU = u; }
+        }
+      }
+      int v = next[bestU];
+      next[bestU] = h; prev[h] = bestU;
+      next[h] = v;     prev[v] = h;
+    }
+    inTour[h] = 1;
+    index.insert(h);
+    edited.push_back(h);
+    ++inserted;
+  }
+  tour.clear();
+  int u = anchor;
+  do { tour.push_back(u); u = next[u]; } while ( u != anchor );
+  repairedValue = DecompositionSolver::tourLength(newHoles, tour, params.metric);
+
+  // 3. local 2-opt from the edited places
+  twoOpt(index, tour, edited);
+
+  // 4. tabu search on the tour positions around the edited places (merged, split into windows);
+  // positions are circular: a window may span the edge from the last position back to the first
+  std::vector<int> pos(n);
+  for ( int p = 0 ; p < n ; ++p ) pos[tour[p]] = p;
+  int window = std::min(n, std::max(5, params.windowSize));
+  std::vector<std::pair<int, int>> ranges;          // [begin, end), begin may be negative
+  for ( int e : edited ) ranges.push_back(std::make_pair(pos[e] - window / 2, pos[e] - window / 2 + window));
+  std::sort(ranges.begin(), ranges.end());
+  DecompositionParams windowParams;
+  windowParams.windowIterations = params.windowIterations;
+  windowParams.alpha = params.alpha;
+  windowParams.beta = params.beta;
+  windowParams.decayFactor = params.decayFactor;
+  windowParams.lambda = params.lambda;
+  windowParams.metric = params.metric;
+  DecompositionSolver windows(windowParams);
+  std::vector<int> path(window);
+  int first = ranges.empty() ? 0 : ranges.front().first;
+  int covered = first;                              // positions before 'covered' are done
+  for ( const auto& range : ranges ) {
+    for ( int begin = std::max(range.first, covered) ; begin < range.second && begin < first + n ; begin += window ) {
+      int start = ( begin % n + n ) % n;
+      for ( int k = 0 ; k < window ; ++k ) path[k] = tour[( start + k ) % n];
+      if ( windows.optimizeWindow(newHoles, path.data(), window, params.seed + start) ) {
+        ++windowsImproved;
+        for ( int k = 0 ; k < window ; ++k ) tour[( start + k ) % n] = path[k];
+      }
+      covered = begin + window;
+    }
+  }
+
+  std::rotate(tour.begin(), std::find(tour.begin(), tour.end(), 0), tour.end());
+  return DecompositionSolver::tourLength(newHoles, tour, params.metric);
+}
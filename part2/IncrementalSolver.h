@@ -0,0 +1,85 @@
+/**
+ * @file IncrementalSolver.h
+ * @brief re-optimization of a previous tour after a board edit (holes added or removed)
+ *
+ */
+
+#ifndef INCREMENTALSOLVER_H
+#define INCREMENTALSOLVER_H
+
+#include <vector>
+#include <utility>
+
+#include "../part1/metric.h"
+#include "SpatialIndex.h"
+
+/**
+ * Parameters of the incremental re-optimization
+ */
+struct IncrementalParams {
+  int    neighbours = 8;           // candidate neighbours (insertion points, 2-opt moves)
+  int    windowSize = 100;         // tour positions re-optimized by tabu search around every edit
+  int    windowIterations = 100;   // tabu iterations per window
+  unsigned int seed = 1;
+  double alpha = 0.75;             // tabu parameters of the windows
+  double beta = 0.5;
+  double decayFactor = 0.9;
+  double lambda = 0.01;
+  DistanceMetric metric = METRIC_EUCLIDEAN;
+};
+
+/**
+ * Repairs the tour of a previous revision of a board instead of solving the new board from scratch:
+ * 1. the holes of both boards are matched by coordinates; holes no longer on the board leave the
+ *    tour, the others keep their order
+ * 2. every new hole is inserted at its cheapest position among the edges of its nearest tour holes
+ *    (SpatialIndex: the holes already in the tour)
+ * 3. 2-opt with neighbour lists, started from the edited places only (the new holes and the
+ *    neighbours of the removed ones) and spreading only where moves are applied
+ * 4. the tour positions around every edited place are re-optimized by tabu search as paths with
+ *    fixed endpoints (DecompositionSolver::optimizeWindow)
+ * Apart from the O(n) matching of the boards, the work depends on the size of the edit.
+ */
+class IncrementalSolver
+{
+public:
+  IncrementalSolver ( const IncrementalParams& params ) : params(params) { }
+
+  /** re-optimize a tour after a board edit
+  * @param oldHoles (x, y) of every hole of the previous board
+  * @param oldTour tour over the previous board (hole ids; a closing node is ignored)
+  * @param newHoles (x, y) of every hole of the edited board
+  * @param tour output: tour over the edited board, starting with hole 0 (no closing node)
+  * @return tour length
+  */
+  double solve ( const std::vector<std::pair<int, int>>& oldHoles , const std::vector<int>& oldTour ,
+                 const std::vector<std::pair<int, int>>& newHoles , std::vector<int>& tour );
+
+  int    getKept ( ) const { return kept; }
+  int    getRemoved ( ) const { return removed; }
+  int    getInserted ( ) const { return inserted; }
+  double getRepairedValue ( ) const { return repairedValue; }   // after insertion, before local search
+  long   getTwoOptMoves ( ) const { return twoOptMoves; }
+  long   getWindowsImproved ( ) const { return windowsImproved; }
+
+protected:
+  double distance ( int a , int b ) const;
+  /** 2-opt with neighbour lists from the given nodes (don't-look bits: a node is examined again
+  * only when one of its tour edges changes)
+  * @param index spatial index of the tour holes (neighbour lists, built on first use of a node)
+  * @param tour tour, improved in place
+  * @param start nodes examined first
+  */
+  void twoOpt ( const SpatialIndex& index , std::vector<int>& tour , const std::vector<int>& start );
+
+  IncrementalParams params;
+  const std::vector<std::pair<int, int>>* holes = nullptr;   // holes of the edited board
+  int    kept = 0;
+  int    removed = 0;
+  int    inserted = 0;
+  double repairedValue = 0.0;
+  long   twoOptMoves = 0;
+  long   windowsImproved = 0;
+};
+
+#endif /* INCREMENTALSOLVER_H */
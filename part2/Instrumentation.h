@@ -0,0 +1,163 @@
+/**
+ * @file Instrumentation.h
+ * @brief search counters, scoped timers, summary table and Chrome trace-event export
+ *
+ */
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+
+/**
+ * Counters and phase timers of one search. A solver holds a pointer to it (nullptr: disabled),
+ * so a disabled build pays one pointer test per phase, never a clock read. Counters of the inner
+ * loop are accumulated in locals and added once per neighbourhood scan.
+ * Timed phases are also recorded as trace events (up to maxEvents, then only totals are kept)
+ * and incumbent improvements as a counter track: load the trace in chrome://tracing or Perfetto.
+ */
+class Instrumentation
+{
+public:
+  enum Counter {
+    ITERATIONS = 0,
+    MOVES_EVALUATED,
+    TABU_BLOCKED,
+    ASPIRATION_ACCEPTED,
+    SHAKES,
+    ELITE_RESTARTS,
+    IMPROVEMENTS,
+    NUM_COUNTERS
+  };
+  enum Timer {
+    NEIGHBORHOOD_SCAN = 0,
+    MOVE_APPLICATION,
+    FREQUENCY_UPDATE,
+    LOGGING,
+    NUM_TIMERS
+  };
+
+  /** @param maxEvents trace events kept (timed phases and incumbent values) */
+  explicit Instrumentation ( size_t maxEvents = 200000 ) : origin(Clock::now()), maxEvents(maxEvents) {
+    for ( int c = 0 ; c < NUM_COUNTERS ; ++c ) counters[c] = 0;
+    for ( int t = 0 ; t < NUM_TIMERS ; ++t ) { totals[t] = 0.0; calls[t] = 0; }
+  }
+
+  static const char* counterName ( int c ) {
+    static const char* names[NUM_COUNTERS] = { "iterations", "moves_evaluated", "tabu_blocked", "aspiration_accepted",
+                                               "shakes", "elite_restarts", "incumbent_improvements" };
+    return names[c];
+  }
+  static const char* timerName ( int t ) {
+    static const char* names[NUM_TIMERS] = { "neighborhood_scan", "move_application", "frequency_update", "logging" };
+    return names[t];
+  }
+
+  /** microseconds since construction */
+  double now ( ) const { return std::chrono::duration<double, std::micro>(Clock::now() - origin).count(); }
+
+  void count ( Counter c , long amount = 1 ) { counters[c] += amount; }
+  long get ( Counter c ) const { return counters[c]; }
+
+  /** record one timed phase (microseconds from now()) */
+  void add ( Timer t , double begin , double end ) {
+    totals[t] += end - begin;
+    ++calls[t];
+    if ( events.size() < maxEvents ) events.push_back(Event{ t, begin, end - begin, 0.0 });
+  }
+  /** record a value on the incumbent counter track */
+  void incumbent ( double value ) {
+    if ( events.size() < maxEvents ) events.push_back(Event{ -1, now(), 0.0, value });
+  }
+
+  /** summary table: counters, then per phase calls, total, mean and share of the elapsed time */
+  void printSummary ( std::ostream& out ) const {
+    double elapsed = now();
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << "---- search instrumentation ----\n";
+    for ( int c = 0 ; c < NUM_COUNTERS ; ++c ) {
+      out << std::left << std::setw(24) << counterName(c) << std::right << std::setw(14) << counters[c] << "\n";
+    }
+    out << std::left << std::setw(24) << "phase" << std::right << std::setw(14) << "calls" << std::setw(14) << "total_ms"
+        << std::setw(14) << "mean_us" << std::setw(10) << "share" << "\n";
+    for ( int t = 0 ; t < NUM_TIMERS ; ++t ) {
+      out << std::left << std::setw(24) << timerName(t) << std::right << std::setw(14) << calls[t]
+          << std::setw(14) << std::fixed << std::setprecision(3) << totals[t] / 1000.0
+          << std::setw(14) << ( calls[t] ? totals[t] / calls[t] : 0.0 )
+          << std::setw(9) << std::setprecision(1) << ( elapsed > 0 ? 100.0 * totals[t] / elapsed : 0.0 ) << "%\n";
+    }
+    out.flags(flags);
+    out.precision(precision);
+    if ( events.size() >= maxEvents ) out << "(trace truncated at " << maxEvents << " events)\n";
+  }
+
+  /** Chrome trace-event JSON: complete events ("X") per timed phase, a counter track ("C") of the
+  * incumbent value, and the final counters as metadata of the process
+  * @param filename output file
+  * @param tid thread id shown in the viewer
+  * @return false if the file cannot be written
+  */
+  bool writeTrace ( const std::string& filename , int tid = 0 ) const {
+    std::ofstream out(filename);
+    if ( !out ) return false;
+    char line[256];
+    out << "{\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":\"tabu search\"}}";
+    for ( const Event& e : events ) {
+      if ( e.timer < 0 ) {
+        snprintf(line, sizeof(line), ",\n{\"name\":\"incumbent\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"value\":%.6f}}",
+                 e.begin, tid, e.value);
+      } else {
+        snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"cat\":\"search\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+                 timerName(e.timer), e.begin, e.duration, tid);
+      }
+      out << line;
+    }
+    out << "\n],\"otherData\":{";
+    for ( int c = 0 ; c < NUM_COUNTERS ; ++c ) out << ( c ? "," : "" ) << "\"" << counterName(c) << "\":" << counters[c];
+    out << "}}\n";
+    return (bool)out;
+  }
+
+protected:
+  typedef std::chrono::steady_clock Clock;
+  struct Event {
+    int    timer;       // Timer, or -1 for an incumbent value
+    double begin;       // microseconds
+    double duration;
+    double value;
+  };
+
+  Clock::time_point  origin;
+  size_t             maxEvents;
+  long               counters[NUM_COUNTERS];
+  double             totals[NUM_TIMERS];
+  long               calls[NUM_TIMERS];
+  std::vector<Event> events;
+};
+
+/**
+ * Times the enclosing scope into an Instrumentation (no-op on nullptr)
+ */
+class ScopedTimer
+{
+public:
+  ScopedTimer ( Instrumentation* instr , Instrumentation::Timer timer ) : instr(instr), timer(timer) {
+    if ( instr ) begin = instr->now();
+  }
+  ~ScopedTimer ( ) { if ( instr ) instr->add(timer, begin, instr->now()); }
+
+private:
+  Instrumentation*      instr;
+  Instrumentation::Timer timer;
+  double                begin = 0.0;
+};
+
+#endif /* INSTRUMENTATION_H */
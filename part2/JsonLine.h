@@ -0,0 +1,189 @@
+/**
+ * @file JsonLine.h
+ * @brief minimal JSON-lines support for the solver server: flat objects in, flat objects out
+ *
+ */
+
+#ifndef JSONLINE_H
+#define JSONLINE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdio>
+
+/**
+ * One field of a request object: a string, a number, a boolean, or an array of numbers
+ * (an array of arrays is flattened: [[1,2],[3,4,5]] -> array 1 2 3 4 5, rows 2 3)
+ */
+struct JsonValue {
+  enum Type { STRING, NUMBER, BOOL, ARRAY, NUL } type = NUL;
+  std::string         str;
+  double              num = 0.0;
+  std::vector<double> array;
+  std::vector<size_t> rows;    // array of arrays: number of values of every inner array (empty otherwise)
+};
+
+typedef std::map<std::string, JsonValue> JsonObject;
+
+/**
+ * Parser for one line holding one flat JSON object (throws std::runtime_error on malformed input)
+ */
+class JsonLineParser
+{
+public:
+  static JsonObject parse ( const std::string& line ) {
+    JsonLineParser p(line);
+    JsonObject obj;
+    p.expect('{');
+    if ( p.peek() == '}' ) { p.next(); p.expectEnd(); return obj; }
+    while ( true ) {
+      std::string key = p.parseString();
+      p.expect(':');
+      obj[key] = p.parseValue();
+      char c = p.next();
+      if ( c == '}' ) break;
+      if ( c != ',' ) throw std::runtime_error("expected ',' or '}'");
+    }
+    p.expectEnd();
+    return obj;
+  }
+
+protected:
+  explicit JsonLineParser ( const std::string& s ) : s(s), pos(0) { }
+
+  void skip ( ) { while ( pos < s.size() && isspace((unsigned char)s[pos]) ) ++pos; }
+  char peek ( ) { skip(); return pos < s.size() ? s[pos] : '\0'; }
+  char next ( ) { char c = peek(); if ( pos < s.size() ) ++pos; return c; }
+  void expect ( char c ) {
+    if ( next() != c ) throw std::runtime_error(std::string("expected '") + c + "'");
+  }
+  /** only white space may follow the object on its line */
+  void expectEnd ( ) {
+    skip();
+    if ( pos < s.size() ) throw std::runtime_error("unexpected text after the object");
+  }
+
+  std::string parseString ( ) {
+    expect('"');
+    std::string out;
+    while ( pos < s.size() && s[pos] != '"' ) {
+      char c = s[pos++];
+      if ( c == '\\' && pos < s.size() ) {
+        char e = s[pos++];
+        switch ( e ) {
+          case 'n': out += '\n'; break;
+          case 't': out += '\t'; break;
+          case 'r': out += '\r'; break;
+          case 'u': pos += 4; out += '?'; break;   // no unicode escapes in paths/ids we produce
+          default:  out += e;
+        }
+      } else {
+        out += c;
+      }
+    }
+    if ( pos >= s.size() ) throw std::runtime_error("unterminated string");
+    ++pos;
+    return out;
+  }
+
+  double parseNumber ( ) {
+    skip();
+    const char* begin = s.c_str() + pos;
+    char* end;
+    double v = strtod(begin, &end);
+    if ( end == begin ) throw std::runtime_error("expected a value");
+    pos += end - begin;
+    return v;
+  }
+
+  /** an array of numbers, or (rows != nullptr) of arrays of numbers: no mixing, no deeper nesting */
+  void parseArray ( std::vector<double>& out , std::vector<size_t>* rows ) {
+    expect('[');
+    if ( peek() == ']' ) { next(); return; }
+    bool inner = ( peek() == '[' );
+    if ( inner && !rows ) throw std::runtime_error("arrays nested too deeply");
+    while ( true ) {
+      if ( ( peek() == '[' ) != inner ) throw std::runtime_error("array mixing numbers and arrays");
+      if ( inner ) {
+        size_t before = out.size();
+        parseArray(out, nullptr);
+        rows->push_back(out.size() - before);
+      } else {
+        out.push_back(parseNumber());
+      }
+      char c = next();
+      if ( c == ']' ) return;
+      if ( c != ',' ) throw std::runtime_error("expected ',' or ']'");
+    }
+  }
+
+  JsonValue parseValue ( ) {
+    JsonValue v;
+    char c = peek();
+    if ( c == '"' ) { v.type = JsonValue::STRING; v.str = parseString(); }
+    else if ( c == '[' ) { v.type = JsonValue::ARRAY; parseArray(v.array, &v.rows); }
+    else if ( s.compare(pos, 4, "true") == 0 ) { v.type = JsonValue::BOOL; v.num = 1; pos += 4; }
+    else if ( s.compare(pos, 5, "false") == 0 ) { v.type = JsonValue::BOOL; v.num = 0; pos += 5; }
+    else if ( s.compare(pos, 4, "null") == 0 ) { v.type = JsonValue::NUL; pos += 4; }
+    else { v.type = JsonValue::NUMBER; v.num = parseNumber(); }
+    return v;
+  }
+
+  const std::string& s;
+  size_t pos;
+};
+
+/**
+ * Builder for one output line: JsonLineWriter().add("id", id).add("value", v).str()
+ */
+class JsonLineWriter
+{
+public:
+  JsonLineWriter& add ( const std::string& key , const std::string& value ) {
+    field(key);
+    out << '"';
+    for ( char c : value ) {
+      if ( c == '"' || c == '\\' ) out << '\\' << c;
+      else if ( c == '\n' ) out << "\\n";
+      else if ( c == '\r' ) out << "\\r";
+      else if ( c == '\t' ) out << "\\t";
+      else if ( (unsigned char)c < 0x20 ) {         // other control characters
+        char buf[8];
+        snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char)c);
+        out << buf;
+      }
+      else out << c;
+    }
+    out << '"';
+    return *this;
+  }
+  JsonLineWriter& add ( const std::string& key , const char* value ) { return add(key, std::string(value)); }
+  JsonLineWriter& add ( const std::string& key , double value ) {
+    field(key);
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.10g", value);
+    out << buf;
+    return *this;
+  }
+  JsonLineWriter& add ( const std::string& key , long value ) { field(key); out << value; return *this; }
+  JsonLineWriter& add ( const std::string& key , const std::vector<int>& values ) {
+    field(key);
+    out << '[';
+    for ( size_t i = 0 ; i < values.size() ; ++i ) out << ( i ? "," : "" ) << values[i];
+    out << ']';
+    return *this;
+  }
+  std::string str ( ) const { return out.str() + "}\n"; }
+
+protected:
+  void field ( const std::string& key ) { out << ( first ? "{" : "," ) << '"' << key << "\":"; first = false; }
+
+  std::ostringstream out;
+  bool first = true;
+};
+
+#endif /* JSONLINE_H */
@@ -0,0 +1,73 @@
+/**
+ * @file LowerBound.cpp
+ * @brief lower bounds on the optimal tour value (for optimality gap reporting)
+ *
+ */
+
+#include "LowerBound.h"
+#include "HeldKarpBound.h"
+
+#include <limits>
+
+double TSPLowerBound::mst ( ) const
+{
+  int n = tsp.n;
+  if ( n < 2 ) return 0.0;
+
+  const double INF = std::numeric_limits<double>::infinity();
+  std::vector<double> key(n, INF);
+  std::vector<bool>   inTree(n, false);
+  double total = 0.0;
+  int v = 0;
+  inTree[v] = true;
+  for ( int added = 1 ; added < n ; ++added ) {
+    int next = -1;
+    for ( int u = 0 ; u < n ; ++u ) {
+      if ( inTree[u] ) continue;
+      if ( tsp.dist(v, u) < key[u] ) key[u] = tsp.dist(v, u);
+      if ( next < 0 || key[u] < key[next] ) next = u;
+    }
+    inTree[next] = true;
+    total += key[next];
+    v = next;
+  }
+  return total;
+}
+
+double TSPLowerBound::nearestNeighbourValue ( ) const
+{
+  int n = tsp.n;
+  if ( n < 2 ) return 0.0;
+
+  std::vector<bool> visited(n, false);
+  double total = 0.0;
+  int curr = 0;
+  visited[curr] = true;
+  for ( int k = 1 ; k < n ; ++k ) {
+    int next = -1;
+    for ( int u = 0 ; u < n ; ++u ) {
+      if ( !visited[u] && ( next < 0 || tsp.dist(curr, u) < tsp.dist(curr, next) ) ) next = u;
+    }
+    visited[next] = true;
+    total += tsp.dist(curr, next);
+    curr = next;
+  }
+  return total + tsp.dist(curr, 0);
+}
+
+double TSPLowerBound::heldKarp ( double upperBound , int maxIter ) const
+{
+  int n = tsp.n;
+  if ( n < 3 ) return mst() * 2;                  // 0 or 1 edge, travelled twice
+
+  if ( upperBound <= 0 ) upperBound = nearestNeighbourValue();
+  if ( maxIter <= 0 ) maxIter = std::max(100, 10 * n);
+
+  HeldKarpBound hk(tsp);
+  std::vector<double> pi(n, 0.0);
+  OneTree tree;
+  double bound = hk.ascent(std::vector<signed char>(), pi, upperBound, maxIter, tree);
+
+  // the 1-tree with zero penalties already dominates the MST bound
+  return std::max(bound, mst());
+}
@@ -0,0 +1,56 @@
+/**
+ * @file LowerBound.h
+ * @brief lower bounds on the optimal tour value (for optimality gap reporting)
+ *
+ */
+
+#ifndef LOWERBOUND_H
+#define LOWERBOUND_H
+
+#include <vector>
+
+#include "TSP.h"
+
+/**
+ * Class that computes lower bounds on the optimal tour of a (symmetric) TSP instance:
+ * - the minimum spanning tree bound (a tour minus one edge is a spanning tree)
+ * - the Held-Karp bound (1-tree relaxation improved by subgradient ascent)
+ * Both run in O(n^2) per spanning tree on the dense cost matrix.
+ */
+class TSPLowerBound
+{
+public:
+  TSPLowerBound ( const TSP& tsp ) : tsp(tsp) { }
+
+  /** weight of a minimum spanning tree (Prim)
+  * @return MST bound
+  */
+  double mst ( ) const;
+
+  /** Held-Karp bound by subgradient ascent on the 1-tree relaxation
+  * @param upperBound value of a known tour (<= 0: a nearest neighbour tour is used)
+  * @param maxIter number of subgradient iterations (<= 0: derived from n)
+  * @return Held-Karp bound
+  */
+  double heldKarp ( double upperBound = 0.0 , int maxIter = 0 ) const;
+
+  /** value of the nearest neighbour tour starting from node 0
+  * @return tour value
+  */
+  double nearestNeighbourValue ( ) const;
+
+  /** relative optimality gap of a tour w.r.t. a bound
+  * @param value tour value
+  * @param bound lower bound
+  * @return (value - bound) / value
+  */
+  static double gap ( double value , double bound ) {
+    if ( value <= 0 ) return 0.0;
+    return ( value - bound ) / value;
+  }
+
+protected:
+  const TSP& tsp;
+};
+
+#endif /* LOWERBOUND_H */
@@ -0,0 +1,210 @@
+/**
+ * @file MemeticSolver.cpp
+ * @brief memetic search: partition crossover (GPX) of elite tours, children polished by tabu search
+ *
+ */
+
+#include "MemeticSolver.h"
+#include "WorkStealingPool.h"
+
+#include <chrono>
+#include <numeric>
+#include <algorithm>
+#include <cmath>
+
+/** union-find with path halving (components of the union graph) */
+static int findRoot ( std::vector<int>& parent , int u )
+{
+  while ( parent[u] != u ) {
+    parent[u] = parent[parent[u]];
+    u = parent[u];
+  }
+  return u;
+}
+
+/** length of a tour in the TSPSolution layout <0, ..., 0> */
+static double tourLength ( const TSP& tsp , const TSPSolution& sol )
+{
+  double total = 0.0;
+  for ( size_t i = 0 ; i + 1 < sol.sequence.size() ; ++i ) total += tsp.dist(sol.sequence[i], sol.sequence[i + 1]);
+  return total;
+}
+
+TSPSolution MemeticSolver::partitionCrossover ( const TSP& tsp , const TSPSolution& a , const TSPSolution& b , int& partitions )
+{
+  partitions = 0;
+  const int n = tsp.n;
+  // the child is built on the better parent X, taking the other parent Y's path where shorter
+  const TSPSolution& x = ( tourLength(tsp, a) <= tourLength(tsp, b) ) ? a : b;
+  const TSPSolution& y = ( &x == &a ) ? b : a;
+
+  // cyclic tours (the closing node is dropped) and positions
+  std::vector<int> X(x.sequence.begin(), x.sequence.begin() + n);
+  std::vector<int> Y(y.sequence.begin(), y.sequence.begin() + n);
+  std::vector<int> posX(n), posY(n);
+  for ( int p = 0 ; p < n ; ++p ) { posX[X[p]] = p; posY[Y[p]] = p; }
+  auto nextX = [&]( int u ) { return X[( posX[u] + 1 ) % n]; };
+  auto prevX = [&]( int u ) { return X[( posX[u] + n - 1 ) % n]; };
+  auto nextY = [&]( int u ) { return Y[( posY[u] + 1 ) % n]; };
+  auto prevY = [&]( int u ) { return Y[( posY[u] + n - 1 ) % n]; };
+
+  // components of the union graph without the shared edges
+  std::vector<int> parent(n);
+  std::iota(parent.begin(), parent.end(), 0);
+  std::vector<char> touched(n, 0);
+  for ( int u = 0 ; u < n ; ++u ) {
+    int v = nextX(u);
+    if ( nextY(u) != v && prevY(u) != v ) { parent[findRoot(parent, u)] = findRoot(parent, v); touched[u] = touched[v] = 1; }
+    int w = nextY(u);
+    if ( nextX(u) != w && prevX(u) != w ) { parent[findRoot(parent, u)] = findRoot(parent, w); touched[u] = touched[w] = 1; }
+  }
+  std::vector<int> comp(n, -1);              // -1: node whose edges are all shared
+  for ( int u = 0 ; u < n ; ++u ) if ( touched[u] ) comp[u] = findRoot(parent, u);
+
+  // a component is a partition if each tour crosses it as a single path (the edges leaving it are
+  // shared, so both paths then join the same entry and exit nodes)
+  std::vector<int> runsX(n, 0), runsY(n, 0), size(n, 0);
+  std::vector<double> costX(n, 0.0), costY(n, 0.0);
+  for ( int p = 0 ; p < n ; ++p ) {
+    int u = X[p];
+    if ( comp[u] >= 0 ) {
+      ++size[comp[u]];
+      if ( comp[prevX(u)] != comp[u] ) ++runsX[comp[u]];
+      if ( comp[nextX(u)] == comp[u] ) costX[comp[u]] += tsp.dist(u, nextX(u));
+    }
+    int v = Y[p];
+    if ( comp[v] >= 0 ) {
+      if ( comp[prevY(v)] != comp[v] ) ++runsY[comp[v]];
+      if ( comp[nextY(v)] == comp[v] ) costY[comp[v]] += tsp.dist(v, nextY(v));
+    }
+  }
+  std::vector<char> takeY(n, 0);
+  for ( int c = 0 ; c < n ; ++c ) {
+    if ( runsX[c] != 1 || runsY[c] != 1 ) continue;   // not a partition: X's paths
+    ++partitions;
+    takeY[c] = costY[c] < costX[c];
+  }
+
+  // walk X from a component boundary (a run is then never entered in the middle)
+  int start = -1;
+  for ( int p = 0 ; p < n && start < 0 ; ++p ) {
+    if ( comp[X[p]] < 0 || comp[X[p]] != comp[X[( p + n - 1 ) % n]] ) start = p;
+  }
+  if ( start < 0 || partitions == 0 ) return x;
+
+  std::vector<int> child;
+  child.reserve(n);
+  int p = start, count = 0;
+  while ( count < n ) {
+    int u = X[p];
+    int c = comp[u];
+    if ( c >= 0 && takeY[c] ) {
+      // u enters the partition: Y's path from u covers the same nodes and leaves at the same exit
+      int q = posY[u];
+      int step = ( comp[Y[( q + 1 ) % n]] == c ) ? 1 : n - 1;
+      for ( int k = 0 ; k < size[c] ; ++k ) {
+        child.push_back(Y[q]);
+        q = ( q + step ) % n;
+      }
+      p = ( p + size[c] ) % n;
+      count += size[c];
+    } else {
+      child.push_back(u);
+      p = ( p + 1 ) % n;
+      ++count;
+    }
+  }
+
+  // rotate to the TSPSolution layout <0, ..., 0>
+  TSPSolution result(x);
+  int zero = std::find(child.begin(), child.end(), 0) - child.begin();
+  for ( int k = 0 ; k < n ; ++k ) result.sequence[k] = child[( zero + k ) % n];
+  result.sequence[n] = 0;
+  return result;
+}
+
+void MemeticSolver::insert ( const ScoredSolution& candidate )
+{
+  for ( const ScoredSolution& s : population ) {
+    if ( std::abs(s.score - candidate.score) < 1e-7 ) return;   // (almost surely) the same tour
+  }
+  if ( (int)population.size() < params.populationSize ) {
+    population.push_back(candidate);
+    ++accepted;
+    return;
+  }
+  auto worst = std::max_element(population.begin(), population.end(),
+    []( const ScoredSolution& x , const ScoredSolution& y ) { return x.score < y.score; });
+  if ( candidate.score < worst->score ) {
+    *worst = candidate;
+    ++accepted;
+  }
+}
+
+double MemeticSolver::solve ( const TSP& tsp , TSPSolution& bestSol )
+{
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point t0 = Clock::now();
+  auto elapsed = [&t0] { return std::chrono::duration<double>(Clock::now() - t0).count(); };
+
+  population.clear();
+  generation = 0;
+  accepted = 0;
+  partitionsFound = 0;
+  WorkStealingPool pool(std::max(1, params.threads));
+
+  // initial population: the elite pools of independent tabu runs
+  int runs = std::max(1, params.initRuns);
+  std::vector<std::vector<ScoredSolution>> elites(runs);
+  for ( int r = 0 ; r < runs ; ++r ) {
+    pool.submit([&, r] {
+      TSPSolver solver("", params.alpha, params.beta, params.decayFactor, params.lambda);
+      solver.setVerbose(false);
+      solver.setSeed(params.seed + 7919u * r);
+      solver.setTargetValue(params.targetValue);
+      TSPSolution init(tsp);
+      if ( r > 0 || !TourConstruction(tsp).build(params.init, init) ) solver.initRnd(init);
+      solver.start(tsp, init);
+      solver.resume(tsp, params.initIterations);
+      elites[r] = solver.getEliteSolutions();
+    });
+  }
+  pool.wait();
+  for ( const auto& elite : elites ) for ( const ScoredSolution& s : elite ) insert(s);
+
+  auto best = [this] {
+    return std::min_element(population.begin(), population.end(),
+      []( const ScoredSolution& x , const ScoredSolution& y ) { return x.score < y.score; });
+  };
+  while ( generation < params.generations && population.size() >= 2 ) {
+    if ( params.timeLimit > 0 && elapsed() >= params.timeLimit ) break;
+    if ( params.targetValue >= 0 && best()->score <= params.targetValue ) break;
+    std::vector<ScoredSolution> children(params.offspring);
+    std::vector<int> parts(params.offspring, 0);
+    for ( int k = 0 ; k < params.offspring ; ++k ) {
+      pool.submit([&, k] {
+        std::mt19937 rng(params.seed ^ ( 1000003u * ( generation + 1 ) + 7919u * k ));
+        int i = rng() % population.size();
+        int j = rng() % ( population.size() - 1 );
+        if ( j >= i ) ++j;
+        TSPSolution child = partitionCrossover(tsp, population[i].sol, population[j].sol, parts[k]);
+        TSPSolver solver("", params.alpha, params.beta, params.decayFactor, params.lambda);
+        solver.setVerbose(false);
+        solver.setSeed(rng());
+        solver.start(tsp, child);
+        solver.resume(tsp, params.polishIterations);
+        children[k].sol = solver.getIncumbent();
+        children[k].score = solver.evaluate(children[k].sol, tsp);
+      });
+    }
+    pool.wait();
+    ++generation;
+    for ( int k = 0 ; k < params.offspring ; ++k ) {   // submission order: reproducible
+      partitionsFound += parts[k];
+      insert(children[k]);
+    }
+  }
+
+  bestSol = best()->sol;
+  return best()->score;
+}
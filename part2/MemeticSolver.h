@@ -0,0 +1,88 @@
+/**
+ * @file MemeticSolver.h
+ * @brief memetic search: partition crossover (GPX) of elite tours, children polished by tabu search
+ *
+ */
+
+#ifndef MEMETICSOLVER_H
+#define MEMETICSOLVER_H
+
+#include <vector>
+#include <random>
+
+#include "TSPSolver.h"
+#include "TourConstruction.h"
+
+/**
+ * Parameters of the memetic search
+ */
+struct MemeticParams {
+  int    populationSize = 10;     // elite tours kept (the size of a tabu run's elite pool)
+  int    generations = 50;
+  int    offspring = 8;           // children per generation (polished in parallel)
+  int    initRuns = 4;            // independent tabu runs seeding the population
+  int    initIterations = 1000;   // tabu iterations of each initial run
+  int    polishIterations = 200;  // tabu iterations applied to each child
+  int    threads = 1;
+  double timeLimit = 0.0;         // seconds (0: generations only)
+  double targetValue = -1.0;      // stop once the best tour is <= this value (< 0: disabled)
+  ConstructionMethod init = CONSTRUCT_RANDOM;   // initial tour of the first run (the others start from random tours)
+  unsigned int seed = 1;
+  double alpha = 0.75;            // tabu parameters of the initial runs and of the polishing
+  double beta = 0.5;
+  double decayFactor = 0.9;
+  double lambda = 0.01;
+};
+
+/**
+ * Memetic engine over a population of elite tours.
+ * - initialization: independent tabu runs (different seeds, in parallel); their elite pools are
+ *   merged into the population (best distinct tours)
+ * - termination: generations, time limit, or target value reached (by an initial run or a child)
+ * - generation: 'offspring' children, each from two random parents through generalized partition
+ *   crossover, then polished by a short tabu search; children are computed in parallel on a
+ *   work-stealing pool and merged in submission order, so a run is reproducible for a given seed
+ *   whatever the number of threads
+ * - replacement: a child enters the population if it is better than the worst tour and not
+ *   already present
+ */
+class MemeticSolver
+{
+public:
+  MemeticSolver ( const MemeticParams& params ) : params(params) { }
+
+  /** run the memetic search
+  * @param tsp TSP instance
+  * @param bestSol best tour found
+  * @return value of bestSol
+  */
+  double solve ( const TSP& tsp , TSPSolution& bestSol );
+
+  /** generalized partition crossover (GPX): the union graph of the two parents minus their
+  * shared edges splits into components; every component crossed by both tours as a single path
+  * (same entry and exit) is a partition, and the child takes, in each partition independently,
+  * the shorter of the two parents' paths (the best of the 2^k recombinations). Other components
+  * keep the path of the better parent.
+  * @param tsp TSP instance
+  * @param a first parent
+  * @param b second parent
+  * @param partitions number of feasible partitions found (0: the child is the better parent)
+  * @return child tour
+  */
+  static TSPSolution partitionCrossover ( const TSP& tsp , const TSPSolution& a , const TSPSolution& b , int& partitions );
+
+  int    getGenerations ( ) const { return generation; }
+  long   getChildrenAccepted ( ) const { return accepted; }
+  long   getPartitions ( ) const { return partitionsFound; }
+
+protected:
+  void insert ( const ScoredSolution& candidate );
+
+  MemeticParams               params;
+  std::vector<ScoredSolution> population;
+  int                         generation = 0;
+  long                        accepted = 0;
+  long                        partitionsFound = 0;
+};
+
+#endif /* MEMETICSOLVER_H */
@@ -0,0 +1,352 @@
+/**
+ * @file SolverServer.cpp
+ * @brief long-running tabu search service: bounded job queue, worker threads, warm instance cache
+ *
+ */
+
+#include "SolverServer.h"
+#include "TSPSolver.h"
+#include "JsonLine.h"
+
+#include <chrono>
+#include <ctime>
+#include <cerrno>
+#include <climits>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/stat.h>
+
+JobOutput::~JobOutput ( )
+{
+  if ( owned ) close(fd);
+}
+
+bool JobOutput::writeLine ( const std::string& line )
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  if ( closed ) return false;
+  size_t done = 0;
+  while ( done < line.size() ) {
+    ssize_t w = write(fd, line.data() + done, line.size() - done);
+    if ( w < 0 && errno == EINTR ) continue;
+    if ( w <= 0 ) {
+      closed = true;
+      return false;
+    }
+    done += w;
+  }
+  return true;
+}
+
+SolverServer::SolverServer ( int numWorkers , size_t queueCapacity , size_t cacheCapacity , const std::string& cacheDir ) :
+  queueCapacity(std::max<size_t>(1, queueCapacity)), cacheCapacity(cacheCapacity), cacheDir(cacheDir)
+{
+  if ( numWorkers < 1 ) numWorkers = 1;
+  for ( int i = 0 ; i < numWorkers ; ++i ) workers.emplace_back(&SolverServer::run, this);
+}
+
+SolverServer::~SolverServer ( )
+{
+  shutdown();
+}
+
+bool SolverServer::submit ( const std::shared_ptr<SolverJob>& job )
+{
+  std::unique_lock<std::mutex> lock(mtx);
+  notFull.wait(lock, [this] { return stopping || queue.size() < queueCapacity; });
+  if ( stopping ) return false;
+  queue.push_back(job);
+  notEmpty.notify_one();
+  return true;
+}
+
+int SolverServer::cancel ( const std::shared_ptr<JobOutput>& output , const std::string& id )
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  int count = 0;
+  for ( auto& job : queue )   if ( job->output == output && job->id == id ) { job->cancelled = true; ++count; }
+  for ( auto& job : running ) if ( job->output == output && job->id == id ) { job->cancelled = true; ++count; }
+  return count;
+}
+
+void SolverServer::cancelAll ( const std::shared_ptr<JobOutput>& output )
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  for ( auto& job : queue )   if ( job->output == output ) job->cancelled = true;
+  for ( auto& job : running ) if ( job->output == output ) job->cancelled = true;
+}
+
+void SolverServer::shutdown ( )
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    if ( stopping && workers.empty() ) return;
+    stopping = true;
+  }
+  notEmpty.notify_all();
+  notFull.notify_all();
+  for ( std::thread& t : workers ) t.join();
+  workers.clear();
+}
+
+void SolverServer::run ( )
+{
+  while ( true ) {
+    std::shared_ptr<SolverJob> job;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      notEmpty.wait(lock, [this] { return stopping || !queue.empty(); });
+      if ( queue.empty() ) return;            // stopping and nothing left
+      job = queue.front();
+      queue.pop_front();
+      running.push_back(job);
+    }
+    notFull.notify_one();
+
+    solve(*job);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    running.erase(std::find(running.begin(), running.end(), job));
+  }
+}
+
+std::shared_ptr<const TSP> SolverServer::instance ( const SolverJob& job , bool& hit , std::string& error )
+{
+  // key: the file identity (path, size, modification time) or the content hash of inline boards
+  std::string key;
+  std::vector<Hole> inlineHoles;
+  int size = job.size;
+  if ( !job.board.empty() ) {
+    struct stat st;
+    if ( stat(job.board.c_str(), &st) != 0 ) {
+      error = "cannot open board " + job.board;
+      return nullptr;
+    }
+    key = "file:" + job.board + ":" + std::to_string((long long)st.st_size) + ":" + std::to_string((long long)st.st_mtime);
+  } else {
+    if ( job.holes.size() < 3 ) {
+      error = "a board needs at least 3 holes";
+      return nullptr;
+    }
+    inlineHoles.reserve(job.holes.size());
+    for ( const auto& h : job.holes ) {
+      if ( h.first < 0 || h.second < 0 || h.first == INT_MAX || h.second == INT_MAX ) {   // size = max + 1 must fit
+        error = "hole coordinates must be between 0 and " + std::to_string(INT_MAX - 1);
+        return nullptr;
+      }
+      inlineHoles.push_back(Hole{h.first, h.second});
+      size = std::max(size, std::max(h.first, h.second) + 1);
+    }
+    char hash[32];
+    snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)boardHash(size, inlineHoles.data(), inlineHoles.size()));
+    key = std::string("inline:") + hash;
+  }
+  key += job.symmetric ? ":sym" : ":full";
+
+  {
+    std::lock_guard<std::mutex> lock(cacheMtx);
+    auto it = lruIndex.find(key);
+    if ( it != lruIndex.end() ) {
+      lru.splice(lru.begin(), lru, it->second);   // move to front
+      hit = true;
+      ++hits;
+      return it->second->second;
+    }
+  }
+  hit = false;
+  ++misses;
+
+  // built outside the lock: other workers keep solving meanwhile
+  std::shared_ptr<TSP> tsp(new TSP());
+  if ( !job.board.empty() ) {
+    bool ok;
+    if ( cacheDir.empty() ) {
+      ok = tsp->load(job.board.c_str());
+      if ( ok ) tsp->computeCostMatrix(job.symmetric);
+    } else {
+      InstanceCacheOptions options;
+      options.dir = cacheDir;
+      ok = tsp->loadCached(job.board.c_str(), options, job.symmetric);
+    }
+    if ( !ok ) {
+      error = "cannot read board " + job.board;
+      return nullptr;
+    }
+    if ( tsp->n < 3 ) {
+      error = "a board needs at least 3 holes";
+      return nullptr;
+    }
+  } else {
+    tsp->gridSize = size;
+    tsp->holes = job.holes;
+    tsp->n = tsp->holes.size();
+    tsp->computeCostMatrix(job.symmetric);
+  }
+
+  std::lock_guard<std::mutex> lock(cacheMtx);
+  auto it = lruIndex.find(key);
+  if ( it != lruIndex.end() ) return it->second->second;   // loaded concurrently by another worker
+  if ( cacheCapacity == 0 ) return tsp;
+  lru.push_front(CacheEntry(key, tsp));
+  lruIndex[key] = lru.begin();
+  while ( lru.size() > cacheCapacity ) {
+    lruIndex.erase(lru.back().first);
+    lru.pop_back();                                         // jobs still using it keep their shared_ptr
+  }
+  return tsp;
+}
+
+void SolverServer::solve ( SolverJob& job )
+{
+  typedef std::chrono::steady_clock Clock;
+  Clock::time_point t0 = Clock::now();
+  auto elapsed = [&t0] { return std::chrono::duration<double>(Clock::now() - t0).count(); };
+
+  if ( job.cancelled || job.output->isClosed() ) {
+    job.output->writeLine(JsonLineWriter().add("id", job.id).add("status", "cancelled").add("iterations", 0L).str());
+    return;
+  }
+
+  bool hit = false;
+  std::string error;
+  std::shared_ptr<const TSP> tsp = instance(job, hit, error);
+  if ( !tsp ) {
+    job.output->writeLine(JsonLineWriter().add("id", job.id).add("status", "error").add("error", error).str());
+    return;
+  }
+  double loadTime = elapsed();
+
+  TSPSolver solver("", job.alpha, job.beta, job.decayFactor, job.lambda);
+  solver.setVerbose(false);
+  solver.setSeed(job.seed ? job.seed : (unsigned int)time(NULL));
+  TSPSolution init(*tsp);
+  solver.initRnd(init);
+
+  // the search runs one iteration at a time, so cancellation and the time budget are checked
+  // between iterations (TSPSolver::solve runs maxIterations + 1 of them)
+  std::string status = "done";
+  try {
+    solver.start(*tsp, init);
+    double searchStart = elapsed();
+    while ( solver.getIteration() <= job.maxIterations ) {
+      if ( job.cancelled || job.output->isClosed() ) { status = "cancelled"; break; }
+      if ( job.timeLimit > 0 && elapsed() - searchStart >= job.timeLimit ) { status = "timeout"; break; }
+      if ( !solver.resume(*tsp, 1) ) break;
+    }
+  } catch ( std::exception& e ) {
+    job.output->writeLine(JsonLineWriter().add("id", job.id).add("status", "error").add("error", e.what()).str());
+    return;
+  }
+
+  std::vector<int> tour = solver.getIncumbent().sequence;
+  if ( !tour.empty() ) tour.pop_back();                     // closing node
+  job.output->writeLine(JsonLineWriter()
+                        .add("id", job.id)
+                        .add("status", status)
+                        .add("value", solver.evaluate(solver.getIncumbent(), *tsp))
+                        .add("iterations", (long)solver.getIteration())
+                        .add("holes", (long)tsp->n)
+                        .add("cached", hit ? "hit" : "miss")
+                        .add("load_sec", loadTime)
+                        .add("time_sec", elapsed())
+                        .add("tour", tour)
+                        .str());
+}
+
+JobFeeder::JobFeeder ( SolverServer& server , size_t readAhead ) :
+  server(server), readAhead(std::max<size_t>(1, readAhead))
+{
+  feeder = std::thread(&JobFeeder::run, this);
+}
+
+JobFeeder::~JobFeeder ( )
+{
+  finish();
+}
+
+bool JobFeeder::park ( const std::shared_ptr<SolverJob>& job )
+{
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    changed.wait(lock, [this] { return rejected || parked.size() < readAhead; });
+    if ( !rejected ) {
+      parked.push_back(job);
+      changed.notify_all();
+      return true;
+    }
+  }
+  job->output->writeLine(JsonLineWriter().add("id", job->id).add("status", "rejected").str());
+  return false;
+}
+
+int JobFeeder::cancel ( const std::shared_ptr<JobOutput>& output , const std::string& id )
+{
+  std::vector<std::shared_ptr<SolverJob>> dropped;
+  bool flagged = false;
+  int count;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    for ( auto it = parked.begin() ; it != parked.end() ; ) {
+      if ( (*it)->output == output && (*it)->id == id ) {
+        dropped.push_back(*it);
+        it = parked.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if ( submitting && submitting->output == output && submitting->id == id ) {
+      submitting->cancelled = true;                 // reported by the worker once queued
+      flagged = true;
+    }
+    count = server.cancel(output, id);
+    if ( count == 0 && flagged ) count = 1;         // not in the server queue yet
+  }
+  changed.notify_all();
+  for ( const auto& job : dropped ) {
+    job->output->writeLine(JsonLineWriter().add("id", job->id).add("status", "cancelled").add("iterations", 0L).str());
+  }
+  return count + dropped.size();
+}
+
+void JobFeeder::finish ( )
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    done = true;
+  }
+  changed.notify_all();
+  if ( feeder.joinable() ) feeder.join();
+}
+
+void JobFeeder::run ( )
+{
+  while ( true ) {
+    std::shared_ptr<SolverJob> job;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      changed.wait(lock, [this] { return done || !parked.empty(); });
+      if ( parked.empty() ) return;               // done and nothing left
+      job = parked.front();
+      parked.pop_front();
+      submitting = job;
+    }
+    changed.notify_all();
+
+    bool accepted = server.submit(job);           // the only place that waits for queue room
+
+    std::deque<std::shared_ptr<SolverJob>> left;
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      submitting.reset();
+      if ( !accepted ) {
+        rejected = true;
+        left.swap(parked);
+      }
+    }
+    if ( accepted ) continue;
+    changed.notify_all();
+    left.push_front(job);
+    for ( const auto& j : left ) j->output->writeLine(JsonLineWriter().add("id", j->id).add("status", "rejected").str());
+    return;
+  }
+}
@@ -0,0 +1,183 @@
+/**
+ * @file SolverServer.h
+ * @brief long-running tabu search service: bounded job queue, worker threads, warm instance cache
+ *
+ */
+
+#ifndef SOLVERSERVER_H
+#define SOLVERSERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <utility>
+
+#include "TSP.h"
+
+/**
+ * Destination of the result lines of one client (stdout, or one socket connection).
+ * Lines are written whole under a lock, so results of concurrent jobs never interleave;
+ * once a write fails (client gone) the output is marked closed and its jobs are cancelled.
+ */
+class JobOutput
+{
+public:
+  /** @param fd file descriptor to write to
+  * @param owned close the descriptor when the output is destroyed (socket connections)
+  */
+  JobOutput ( int fd , bool owned ) : fd(fd), owned(owned) { }
+  ~JobOutput ( );
+
+  /** write one complete line
+  * @return false if the client is gone
+  */
+  bool writeLine ( const std::string& line );
+  bool isClosed ( ) const { return closed; }
+  /** the client has disconnected: drop further lines */
+  void markClosed ( ) { closed = true; }
+
+protected:
+  int               fd;
+  bool              owned;
+  std::mutex        mtx;
+  std::atomic<bool> closed { false };
+};
+
+/**
+ * One solve request: a board file or inline coordinates, tabu parameters and budgets
+ */
+struct SolverJob {
+  std::string id;
+  std::string board;                            // board file (any board_io format), or ...
+  int         size = 0;                         // ... inline board: side (0: from the coordinates)
+  std::vector<std::pair<int, int>> holes;       //     and hole coordinates
+  bool        symmetric = false;                // packed triangular storage
+  double      alpha = 0.75;
+  double      beta = 0.5;
+  double      decayFactor = 0.9;
+  double      lambda = 0.01;
+  int         maxIterations = 1000;
+  double      timeLimit = 0.0;                  // seconds of search (0: iterations only)
+  unsigned int seed = 0;                        // 0: seeded from the clock
+  std::shared_ptr<JobOutput> output;            // where the result goes
+  std::atomic<bool> cancelled { false };
+};
+
+/**
+ * Solver service: jobs are queued in a bounded FIFO and solved by a fixed set of workers.
+ * - backpressure: submit() blocks while the queue is full, so a client writing faster than the
+ *   workers solve is slowed down (its pipe/socket buffer fills up) instead of growing the queue
+ * - cancellation: a queued job is dropped, a running job stops at the next iteration and still
+ *   reports its incumbent (the search runs as a sequence of TSPSolver::resume calls)
+ * - warm cache: the most recently used instances (distance matrix included) are kept in memory
+ *   and shared read-only by the workers, so repeated boards skip parsing and matrix construction
+ */
+class SolverServer
+{
+public:
+  /** @param workers number of solver threads
+  * @param queueCapacity maximum number of jobs waiting for a worker
+  * @param cacheCapacity number of instances kept in memory
+  * @param cacheDir on-disk instance cache for board files (empty: disabled)
+  */
+  SolverServer ( int workers , size_t queueCapacity , size_t cacheCapacity , const std::string& cacheDir = "" );
+  ~SolverServer ( );
+
+  /** queue a job, blocking while the queue is full
+  * @return false if the server is shutting down (the job is not run)
+  */
+  bool submit ( const std::shared_ptr<SolverJob>& job );
+
+  /** cancel the queued or running jobs of a client with a given id
+  * @return number of jobs cancelled
+  */
+  int cancel ( const std::shared_ptr<JobOutput>& output , const std::string& id );
+
+  /** cancel every job of a client (disconnected) */
+  void cancelAll ( const std::shared_ptr<JobOutput>& output );
+
+  /** stop accepting jobs, finish the queued ones and join the workers */
+  void shutdown ( );
+
+  /** in-memory cache statistics */
+  long cacheHits ( ) const { return hits; }
+  long cacheMisses ( ) const { return misses; }
+
+protected:
+  void run ( );
+  void solve ( SolverJob& job );
+  /** instance of a job from the warm cache, loading it on a miss
+  * @param hit set to true if the instance was already in memory
+  * @return nullptr (and error) if the board cannot be read
+  */
+  std::shared_ptr<const TSP> instance ( const SolverJob& job , bool& hit , std::string& error );
+
+  std::vector<std::thread>                  workers;
+  std::deque<std::shared_ptr<SolverJob>>    queue;
+  std::vector<std::shared_ptr<SolverJob>>   running;
+  size_t                                    queueCapacity;
+  bool                                      stopping = false;
+  std::mutex                                mtx;
+  std::condition_variable                   notEmpty;
+  std::condition_variable                   notFull;
+
+  typedef std::pair<std::string, std::shared_ptr<const TSP>> CacheEntry;
+  std::list<CacheEntry>                                       lru;        // most recently used first
+  std::map<std::string, std::list<CacheEntry>::iterator>      lruIndex;
+  size_t                                                      cacheCapacity;
+  std::string                                                 cacheDir;
+  std::mutex                                                  cacheMtx;
+  std::atomic<long>                                           hits { 0 };
+  std::atomic<long>                                           misses { 0 };
+};
+
+/**
+ * Submission of the jobs of one client: the request reader parks jobs here and goes on reading,
+ * a feeder thread submits them in order (waiting on the server's backpressure). Cancellation lines
+ * are thus read and applied while the server queue is full: parked jobs are dropped, queued and
+ * running ones flagged. At most 'readAhead' jobs are parked, beyond that the reader waits too.
+ */
+class JobFeeder
+{
+public:
+  /** @param server server the jobs are submitted to
+  * @param readAhead maximum number of parked jobs
+  */
+  JobFeeder ( SolverServer& server , size_t readAhead );
+  ~JobFeeder ( );
+
+  /** hand a job over for submission, blocking while 'readAhead' jobs are parked
+  * @return false if the server no longer accepts jobs (the job is reported as rejected)
+  */
+  bool park ( const std::shared_ptr<SolverJob>& job );
+
+  /** cancel the parked, queued or running jobs of a client with a given id
+  * @return number of jobs cancelled
+  */
+  int cancel ( const std::shared_ptr<JobOutput>& output , const std::string& id );
+
+  /** end of requests: submit the parked jobs and join the feeder thread */
+  void finish ( );
+
+protected:
+  void run ( );
+
+  SolverServer&                             server;
+  size_t                                    readAhead;
+  std::deque<std::shared_ptr<SolverJob>>    parked;
+  std::shared_ptr<SolverJob>                submitting;   // waiting for room in the server queue
+  bool                                      done = false;
+  bool                                      rejected = false;
+  std::mutex                                mtx;
+  std::condition_variable                   changed;
+  std::thread                               feeder;
+};
+
+#endif /* SOLVERSERVER_H */
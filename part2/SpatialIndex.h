@@ -0,0 +1,189 @@
+/**
+ * @file SpatialIndex.h
+ * @brief uniform grid over hole coordinates: k-nearest and nearest-remaining queries
+ *
+ */
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "../part1/metric.h"
+
+/** position of (x, y) along the Hilbert curve filling a side x side square (side: power of two) */
+inline uint64_t hilbertIndex ( uint32_t side , uint32_t x , uint32_t y )
+{
+  uint64_t d = 0;
+  for ( uint32_t s = side / 2 ; s > 0 ; s /= 2 ) {
+    uint32_t rx = ( x & s ) > 0;
+    uint32_t ry = ( y & s ) > 0;
+    d += (uint64_t)s * s * ( ( 3 * rx ) ^ ry );
+    if ( ry == 0 ) {                                 // rotate the quadrant
+      if ( rx == 1 ) { x = side - 1 - x; y = side - 1 - y; }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+/** smallest power of two larger than every coordinate (side of the Hilbert square) */
+inline uint32_t hilbertSide ( const std::vector<std::pair<int, int>>& points )
+{
+  uint32_t side = 1;
+  for ( const auto& p : points ) while ( side <= (uint32_t)std::max(p.first, p.second) ) side *= 2;
+  return side;
+}
+
+/**
+ * Bucket grid (about two points per cell, cells stored contiguously) over a subset of the points.
+ * Queries scan rings of cells around the query point and stop as soon as the remaining rings are
+ * farther than the current answer, so they cost O(1) cells on evenly spread boards.
+ * Points can be removed (nearest neighbour tours, matching): a removed point is swapped out of its
+ * cell's live prefix in O(1), and can be put back later (insert) since its cell keeps its slot.
+ */
+class SpatialIndex
+{
+public:
+  /** index a subset of the points
+  * @param points coordinates of every point (non negative)
+  * @param ids points to index (empty: all of them)
+  */
+  SpatialIndex ( const std::vector<std::pair<int, int>>& points , const std::vector<int>& ids = std::vector<int>() ) : points(points) {
+    std::vector<int> all;
+    const std::vector<int>* members = &ids;
+    if ( ids.empty() ) {
+      all.resize(points.size());
+      for ( size_t i = 0 ; i < all.size() ; ++i ) all[i] = i;
+      members = &all;
+    }
+    int count = members->size();
+    int extent = 1;
+    for ( int i : *members ) extent = std::max(extent, std::max(points[i].first, points[i].second) + 1);
+    int cells = std::max(1, (int)std::ceil(std::sqrt(count / 2.0)));
+    cellSide = std::max(1, ( extent + cells - 1 ) / cells);
+    width = std::max(1, ( extent + cellSide - 1 ) / cellSide);
+
+    cellStart.assign((size_t)width * width + 1, 0);
+    for ( int i : *members ) ++cellStart[cellOf(i) + 1];
+    for ( size_t c = 1 ; c < cellStart.size() ; ++c ) cellStart[c] += cellStart[c - 1];
+    items.resize(count);
+    slot.assign(points.size(), -1);
+    std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+    for ( int i : *members ) {
+      slot[i] = fill[cellOf(i)]++;
+      items[slot[i]] = i;
+    }
+    cellLive.assign(cellStart.begin() + 1, cellStart.end());   // nothing removed yet
+    live = count;
+  }
+
+  int  size ( ) const { return live; }
+  bool contains ( int i ) const { return slot[i] >= 0; }
+
+  /** remove a point from the index (no-op if absent) */
+  void remove ( int i ) {
+    if ( slot[i] < 0 ) return;
+    int c = cellOf(i);
+    int last = --cellLive[c];
+    int j = items[last];
+    std::swap(items[slot[i]], items[last]);
+    slot[j] = slot[i];
+    slot[i] = -1;
+    --live;
+  }
+
+  /** put back a point removed earlier (no-op if present or never indexed) */
+  void insert ( int i ) {
+    if ( slot[i] >= 0 ) return;
+    int c = cellOf(i);
+    int t = cellLive[c];
+    while ( t < cellStart[c + 1] && items[t] != i ) ++t;   // removed points of a cell follow its live ones
+    if ( t == cellStart[c + 1] ) return;
+    std::swap(items[t], items[cellLive[c]]);         // the other point stays among the removed ones
+    slot[i] = cellLive[c]++;
+    ++live;
+  }
+
+  /** nearest indexed point to point i (i itself excluded)
+  * @return point id, -1 if none is left
+  */
+  int nearest ( int i ) const {
+    std::vector<int> out;
+    kNearest(i, 1, out);
+    return out.empty() ? -1 : out[0];
+  }
+
+  /** k nearest indexed points to point i (i itself excluded), by increasing distance
+  * @param i query point (indexed or not)
+  * @param k number of neighbours
+  * @param out neighbours (fewer than k if the index is smaller)
+  * @param metric distance the neighbours are chosen and ordered by
+  */
+  void kNearest ( int i , int k , std::vector<int>& out , DistanceMetric metric = METRIC_EUCLIDEAN ) const {
+    if ( metric == METRIC_EUCLIDEAN ) {             // squared distances: no sqrt, exact integers
+      kNearestBy(i, k, out, []( long long dx , long long dy ) { return dx * dx + dy * dy; });
+      return;
+    }
+    withMetric(metric, [&]( auto policy ) {
+      kNearestBy(i, k, out, []( long long dx , long long dy ) { return decltype(policy)::distance((int)dx, (int)dy); });
+    });
+  }
+
+protected:
+  /** kNearest with a distance key(dx, dy) that is monotone in |dx| and |dy| (every metric is):
+  * points beyond ring r are at least key(r * cellSide, 0) away */
+  template <class Key>
+  void kNearestBy ( int i , int k , std::vector<int>& out , Key key ) const {
+    out.clear();
+    if ( k <= 0 ) return;
+    typedef std::pair<decltype(key(0LL, 0LL)), int> Candidate;   // (distance, id)
+    std::priority_queue<Candidate> heap;            // max-heap: worst of the current k on top
+    int cx = std::min(width - 1, points[i].first / cellSide), cy = std::min(width - 1, points[i].second / cellSide);
+    for ( int r = 0 ; r < width ; ++r ) {
+      for ( int y = cy - r ; y <= cy + r ; ++y ) {
+        if ( y < 0 || y >= width ) continue;
+        bool edgeRow = ( y == cy - r || y == cy + r );
+        for ( int x = cx - r ; x <= cx + r ; x += ( edgeRow || r == 0 ) ? 1 : 2 * r ) {
+          if ( x < 0 || x >= width ) continue;
+          int c = y * width + x;
+          for ( int t = cellStart[c] ; t < cellLive[c] ; ++t ) {
+            int j = items[t];
+            if ( j == i ) continue;
+            Candidate cand(key(points[i].first - points[j].first, points[i].second - points[j].second), j);
+            if ( (int)heap.size() < k ) heap.push(cand);
+            else if ( cand < heap.top() ) { heap.pop(); heap.push(cand); }
+          }
+        }
+      }
+      if ( (int)heap.size() == k && heap.top().first <= key((long long)r * cellSide, 0LL) ) break;
+    }
+    out.resize(heap.size());
+    for ( int s = (int)heap.size() - 1 ; s >= 0 ; --s ) {
+      out[s] = heap.top().second;
+      heap.pop();
+    }
+  }
+
+  int cellOf ( int i ) const {
+    int x = std::min(width - 1, points[i].first / cellSide);
+    int y = std::min(width - 1, points[i].second / cellSide);
+    return y * width + x;
+  }
+
+  const std::vector<std::pair<int, int>>& points;
+  int              cellSide;
+  int              width;      // cells per side
+  std::vector<int> cellStart;  // items of cell c: [cellStart[c], cellStart[c + 1])
+  std::vector<int> cellLive;   // ... of which [cellStart[c], cellLive[c]) are not removed
+  std::vector<int> items;
+  std::vector<int> slot;       // position of every point in items (-1: not indexed or removed)
+  int              live;
+};
+
+#endif /* SPATIALINDEX_H */
@@ -0,0 +1,66 @@
+/**
+ * @file SymMatrix.h
+ * @brief symmetric matrix in packed (lower triangular) storage
+ *
+ */
+
+#ifndef SYMMATRIX_H
+#define SYMMATRIX_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * Symmetric n x n matrix storing only the lower triangle (diagonal included):
+ * n(n+1)/2 elements instead of n^2, element (i,j) and (j,i) share the same slot
+ */
+template <typename T>
+class SymMatrix
+{
+public:
+  SymMatrix ( ) : n(0) , elems(nullptr) { }
+  SymMatrix ( int n , T value = T() ) { resize(n, value); }
+  SymMatrix ( const SymMatrix& other ) : n(other.n) , data(other.data) {
+    elems = other.isView() ? other.elems : data.data();
+  }
+  SymMatrix& operator= ( const SymMatrix& other ) {
+    if ( this == &other ) return *this;
+    n = other.n;
+    data = other.data;
+    elems = other.isView() ? other.elems : data.data();
+    return *this;
+  }
+
+  void resize ( int size , T value = T() ) {
+    n = size;
+    data.assign((size_t)n * (n + 1) / 2, value);
+    elems = data.data();
+  }
+  void clear ( ) { n = 0; data.clear(); elems = nullptr; }
+  int  size ( ) const { return n; }
+
+  /** read-only view over packed storage owned elsewhere (e.g. a mapped instance cache file):
+  * it must outlive the matrix and must not be written through operator()
+  */
+  void attach ( int size , const T* packed ) {
+    n = size;
+    std::vector<T>().swap(data);
+    elems = const_cast<T*>(packed);
+  }
+  bool isView ( ) const { return elems != nullptr && elems != data.data(); }
+
+  T& operator() ( int i , int j )             { return elems[index(i, j)]; }
+  const T& operator() ( int i , int j ) const { return elems[index(i, j)]; }
+
+protected:
+  static size_t index ( int i , int j ) {
+    if ( i < j ) { int t = i; i = j; j = t; }
+    return (size_t)i * (i + 1) / 2 + j;
+  }
+
+  int            n;
+  std::vector<T> data;
+  T*             elems;   // data.data(), or the attached external storage
+};
+
+#endif /* SYMMATRIX_H */
@@ -13,65 +13,248 @@
  #include <fstream>
  #include <vector>
  #include <cmath>
+ #include <memory>
+ #include <algorithm>
+
+ #include "SymMatrix.h"
+ #include "SpatialIndex.h"
+ #include "../part1/grid_distance.h"
+ #include "../part1/board_io.h"
+ #include "../part1/instance_cache.h"
  
  /**
   * Class that describes a TSP instance (a cost matrix, nodes are identified by integer 0 ... n-1)
+  * In symmetric mode only the lower triangle of the cost matrix is stored (symCost) and 'cost' stays empty:
+  * use dist(i,j) outside the solver hot loops.
+  * In grid distance mode (useGridDistances) there is no matrix at all: distances are looked up in a
+  * table indexed by the coordinate differences of the holes (or computed from them, for the metrics
+  * without sqrt).
   */
  class TSP
  {
  public:
-   TSP() : n(0) , infinite(1e10) { }
+   TSP() : n(0) , infinite(1e10) , symmetric(false) , gridDistances(false) , gridSize(0) { }
    int n; //number of nodes
    std::vector< std::vector<double> > cost;
    double infinite; // infinite value (an upper bound on the value of any feasible solution)
+   bool symmetric;  // packed triangular storage (distances on the board are symmetric)
+   SymMatrix<double> symCost;
+
+   DistanceMetric metric = METRIC_EUCLIDEAN;  // set before loading (read, loadCached, computeCostMatrix)
+   bool gridDistances;  // no matrix: distances from gridTable, or computed for untabulated metrics ('symmetric' then only selects the solver's frequency storage)
+   GridDistanceTable gridTable;
+
+   double dist ( int i , int j ) const {
+     if ( gridDistances ) {
+       if ( !gridTable.empty() ) return gridTable.between(holes[i], holes[j]);
+       return metricDistance(metric, holes[i].first - holes[j].first, holes[i].second - holes[j].second);
+     }
+     return symmetric ? symCost(i, j) : cost[i][j];
+   }
  
-   void read(const char* filename)
+   int gridSize;    // board side (holes have integer coordinates in [0, gridSize))
+   std::vector<std::pair<int, int>> holes;  // (x = col, y = row) of node i (raster scan order for .dat grids)
+   std::vector<int32_t> originalId;         // hole id in the board file of node i (empty: nodes in file order)
+
+   /** renumber the nodes along a Hilbert curve over the hole coordinates, so that close holes get
+   * close ids and their matrix rows share cache lines and pages (call before computeCostMatrix)
+   */
+   void renumberHilbert()
    {
-       std::ifstream file(filename);
-       if (!file) {
-           std::cerr << "Cannot open file.\n";
-           return;
+       uint32_t side = hilbertSide(holes);
+       std::vector<std::pair<uint64_t, int32_t>> keys(n);
+       for (int i = 0; i < n; ++i) keys[i] = std::make_pair(hilbertIndex(side, holes[i].first, holes[i].second), i);
+       std::sort(keys.begin(), keys.end());
+       std::vector<std::pair<int, int>> sorted(n);
+       std::vector<int32_t> ids(n);
+       for (int k = 0; k < n; ++k) {
+           sorted[k] = holes[keys[k].second];
+           ids[k] = originalId.empty() ? keys[k].second : originalId[keys[k].second];
        }
- 
-       int gridSize;
-       file >> gridSize;
- 
-       std::vector<std::vector<int>> grid(gridSize, std::vector<int>(gridSize));
-       std::vector<std::pair<int, int>> holes;
- 
-       for (int i = 0; i < gridSize; ++i) {
-           for (int j = 0; j < gridSize; ++j) {
-               int val;
-               file >> val;
-               grid[i][j] = val;
-               if (val == 1) {
-                   holes.push_back({j, i});  // (x = col, y = row)
-               }
-           }
+       holes.swap(sorted);
+       originalId.swap(ids);
+   }
+
+   /** a tour in board file hole ids
+   * @param sequence tour over the nodes (closing node included)
+   * @return the same tour over the original ids, starting and ending at hole 0
+   */
+   std::vector<int> originalTour(const std::vector<int>& sequence) const
+   {
+       if (originalId.empty() || sequence.empty()) return sequence;
+       std::vector<int> tour(sequence.begin(), sequence.end() - 1);
+       for (int& node : tour) node = originalId[node];
+       std::rotate(tour.begin(), std::find(tour.begin(), tour.end(), 0), tour.end());
+       tour.push_back(tour[0]);
+       return tour;
+   }
+
+   /** read a board and build the cost matrix (load + computeCostMatrix)
+   * @param filename board file
+   * @param symmetricMode packed triangular storage
+   * @param hilbert renumber the nodes along a Hilbert curve (renumberHilbert)
+   */
+   void read(const char* filename, bool symmetricMode = false, bool hilbert = false)
+   {
+       if (!load(filename)) return;
+       std::cout << "Extracted " << n << " holes from grid.\n";
+       if (hilbert) renumberHilbert();
+       computeCostMatrix(symmetricMode);
+   }
+
+   /** load a board file (dense .dat grid, sparse text or binary hole list, see board_io.h):
+   * fills gridSize, holes and n (no distances yet)
+   * @param filename board file
+   * @return false if the file cannot be read
+   */
+   bool load(const char* filename)
+   {
+       BoardFile board;
+       if (!board.open(filename)) {
+           std::cerr << "Cannot open file: " << board.error() << "\n";
+           return false;
+       }
+       gridSize = board.size();
+       holes.resize(board.count());
+       const Hole* h = board.holes();
+       for (size_t i = 0; i < board.count(); ++i) {
+           holes[i] = std::make_pair(h[i].x, h[i].y);
        }
- 
        n = holes.size();
-       std::cout << "Extracted " << n << " holes from grid.\n";
- 
-       cost.resize(n, std::vector<double>(n, 0.0));
- 
-       for (int i = 0; i < n; ++i) {
-           for (int j = 0; j < n; ++j) {
-               if (i != j) {
-                   double dx = holes[i].first - holes[j].first;
-                   double dy = holes[i].second - holes[j].second;
-                   cost[i][j] = std::sqrt(dx * dx + dy * dy);
-               }
+       originalId.clear();
+       gridDistances = false;
+       return true;
+   }
+
+   std::shared_ptr<CachedInstance> cache;  // mapped cache entry backing holes/symCost (loadCached)
+
+   /** load a board through the on-disk instance cache: on a hit the coordinates and the packed
+   * distance matrix are used in place from the mapped cache file (no parsing of distances, no sqrt);
+   * on a miss the entry is built first
+   * @param filename board file
+   * @param options cache directory, neighbour lists, matrix size limit
+   * @param symmetricMode packed triangular storage (mapped directly; otherwise 'cost' is filled from it)
+   * @param hilbert renumber the nodes along a Hilbert curve (the cached matrix, in file order, is then
+   *        not used: the matrix is rebuilt)
+   * @return false if the board cannot be read
+   */
+   bool loadCached(const char* filename, const InstanceCacheOptions& options, bool symmetricMode = false, bool hilbert = false)
+   {
+       BoardFile board;
+       if (!board.open(filename)) {
+           std::cerr << "Cannot open file: " << board.error() << "\n";
+           return false;
+       }
+       std::shared_ptr<CachedInstance> entry(new CachedInstance());
+       if (!openInstanceCache(board, options, *entry)) {
+           // cache not writable: plain load
+           cache.reset();
+           if (!load(filename)) return false;
+           if (hilbert) renumberHilbert();
+           computeCostMatrix(symmetricMode);
+           return true;
+       }
+       cache = entry;
+       gridSize = entry->size();
+       n = entry->n();
+       holes.resize(n);
+       for (int i = 0; i < n; ++i) holes[i] = std::make_pair(entry->holes()[i].x, entry->holes()[i].y);
+       originalId.clear();
+
+       const double* packed = entry->packedMatrix();
+       if (hilbert) renumberHilbert();
+       if (!packed || hilbert || metric != METRIC_EUCLIDEAN) {   // the cached matrix is Euclidean, in file order
+           computeCostMatrix(symmetricMode);
+           return true;
+       }
+       symmetric = symmetricMode;
+       gridDistances = false;
+       if (symmetric) {
+           cost.clear();
+           symCost.attach(n, packed);
+       } else {
+           symCost.clear();
+           cost.assign(n, std::vector<double>(n, 0.0));
+           for (int i = 0; i < n; ++i) {
+               const double* row = packed + (size_t)i * (i + 1) / 2;
+               for (int j = 0; j < i; ++j) cost[i][j] = cost[j][i] = row[j];
            }
        }
+       infinite = entry->infinite();
+       return true;
+   }
+
+   /** build the cost matrix of the loaded holes (in the instance's metric) and the 'infinite' value;
+   * sqrt-based distances come from the grid table when it is smaller than the matrix (dense boards)
+   * @param symmetricMode packed triangular storage
+   */
+   void computeCostMatrix(bool symmetricMode = false)
+   {
+       symmetric = symmetricMode;
+       gridDistances = false;
+       withMetric(metric, [this](auto policy) { fillCostMatrix<decltype(policy)>(); });
  
        // Set infinite value as upper bound
        infinite = 0;
        for (int i = 0; i < n; ++i)
            for (int j = 0; j < n; ++j)
-               infinite += cost[i][j];
+               infinite += dist(i, j);
        infinite *= 2;
    }
+
+   /** grid distance mode: no cost matrix, every distance is a lookup in a (side x side) table
+   * indexed by (|dx|, |dy|), exact and without sqrt. Memory depends on the board side, not on n.
+   * Metrics without sqrt (not 'tabulated') need no table: their distances are computed from the
+   * coordinate differences, whatever the board side.
+   * @param symmetricMode packed triangular storage of the solver's frequency matrix
+   * @return false (nothing changed) if the board side exceeds GridDistanceTable::MAX_SIDE (tabulated metrics)
+   */
+   bool useGridDistances(bool symmetricMode = false)
+   {
+       int extent = GridDistanceTable::extentOf(holes);
+       if (!metricTabulated(metric)) gridTable.clear();
+       else if (!gridTable.build(extent, metric)) return false;
+       gridDistances = true;
+       symmetric = symmetricMode;
+       cost.clear();
+       symCost.clear();
+       // any bound above every tour value will do: 2 * n^2 * the longest possible edge
+       infinite = 2.0 * n * n * metricDistance(metric, extent - 1, extent - 1) + 1.0;
+       return true;
+   }
+
+ protected:
+   /** fill 'cost' or 'symCost' (per the 'symmetric' flag) with the distances of a metric policy */
+   template <class Metric>
+   void fillCostMatrix()
+   {
+       int extent = GridDistanceTable::extentOf(holes);
+       bool lookup = Metric::tabulated && (size_t)extent * extent <= (size_t)n * n && gridTable.build(extent, metric);
+       auto distance = [this, lookup](int i, int j) {
+           if (lookup) return gridTable.between(holes[i], holes[j]);
+           return Metric::distance(holes[i].first - holes[j].first, holes[i].second - holes[j].second);
+       };
+       if (symmetric) {
+           cost.clear();
+           symCost.resize(n, 0.0);
+           for (int i = 0; i < n; ++i) {
+               for (int j = 0; j < i; ++j) {
+                   symCost(i, j) = distance(i, j);
+               }
+           }
+       } else {
+           symCost.clear();
+           cost.assign(n, std::vector<double>(n, 0.0));
+ 
+           for (int i = 0; i < n; ++i) {
+               for (int j = 0; j < n; ++j) {
+                   if (i != j) {
+                       cost[i][j] = distance(i, j);
+                   }
+               }
+           }
+       }
+   }
  };
  
  #endif /* TSP_H */
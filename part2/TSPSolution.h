@@ -8,6 +8,8 @@
 #define TSPSOLUTION_H
 
 #include <vector>
+#include <string>
+#include <sstream>
 
 #include "TSP.h"
 
@@ -21,6 +23,10 @@ class TSPSolution
 public:
   std::vector<int>		sequence;
 public:
+  /** Constructor 
+  * build an empty solution (to be assigned later)
+  */
+  TSPSolution ( ) { }
   /** Constructor 
   * build a standard solution as the sequence <0, 1, 2, 3 ... n-1, 0>
   * @param tsp TSP instance
@@ -54,6 +60,36 @@ public:
       std::cout << sequence[i] << " ";
     }
   }
+  /** write method
+  * save the solution in the compact tour format (FINAL_SOLUTION / FINAL_VALUE lines, as in the log)
+  * @param filename output file
+  * @param value solution value
+  * @return true if the file has been written
+  */
+  bool write ( const std::string& filename , double value ) const {
+    std::ofstream out(filename);
+    if ( !out ) return false;
+    out << "FINAL_SOLUTION\n";
+    for ( uint i = 0; i < sequence.size(); i++ ) {
+      out << sequence[i] << " ";
+    }
+    out << "\nFINAL_VALUE " << value << "\n";
+    return true;
+  }
+  /** read method
+  * load a solution saved by write (the FINAL_VALUE line is not read)
+  * @param filename input file
+  * @return false if the file cannot be read or holds no tour
+  */
+  bool read ( const std::string& filename ) {
+    std::ifstream in(filename);
+    std::string line;
+    if ( !in || !std::getline(in, line) || line != "FINAL_SOLUTION" || !std::getline(in, line) ) return false;
+    std::istringstream nodes(line);
+    sequence.clear();
+    for ( int node ; nodes >> node ; ) sequence.push_back(node);
+    return !sequence.empty();
+  }
   /** assignment method 
   * copy a solution into another one
   * @param right TSP solution to get into
@@ -62,9 +98,7 @@ public:
   TSPSolution& operator=(const TSPSolution& right) {
     // Handle self-assignment:
     if(this == &right) return *this;
-    for ( uint i = 0; i < sequence.size(); i++ ) {
-      sequence[i] = right.sequence[i];
-    }
+    sequence = right.sequence;
     return *this;
   }
 };
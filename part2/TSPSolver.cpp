@@ -6,188 +6,237 @@
 
 #include "TSPSolver.h"
 #include <iostream>
+#include <sstream>
+#include <cstring>
 
 bool TSPSolver::solve ( const TSP& tsp , const TSPSolution& initSol , int tabulength , int maxIter , TSPSolution& bestSol)
 {
-  // debug arguments
-  log << "Arguments: " << std::endl;
-  log << "alpha: " << alpha << std::endl;
-  log << "beta: " << beta << std::endl;
-  log << "decayFactor: " << decayFactor << std::endl;
-  log << "lambda: " << lambda << std::endl;
-  log << "----------------------------------------" << std::endl;
   try
   {
-    bool stop = false;
-    int  iter = 0;
-
-    ///Tabu Search
-    tabuLength = std::max(5, tsp.n / 10);
-    tabuList.reserve(tsp.n);
-    initTabuList(tsp.n);
-    ///
-    int noImproveThreshold = static_cast<int>(alpha * tsp.n);
-    int tenureAdaptThreshold = static_cast<int>(beta * noImproveThreshold);
-    int shakeThreshold = noImproveThreshold;
-
-    if (shakeThreshold <= tenureAdaptThreshold) {
-      throw std::logic_error("shakeThreshold must be > tenureAdaptThreshold");
+    if ( restored ) restored = false;               /// continue a checkpointed search
+    else start(tsp, initSol);
+    if ( checkpointInterval > 0 ) {
+      std::vector<char> snapshot;
+      while ( iter <= maxIter && resume(tsp, std::min(checkpointInterval, maxIter + 1 - iter)) ) {
+        saveState(tsp, snapshot);
+        checkpointWriter->post(std::move(snapshot));  // written in the background
+      }
+      saveState(tsp, snapshot);                     // final state (a resume of it has nothing left to do)
+      checkpointWriter->post(std::move(snapshot));
+      checkpointWriter->flush();
+    } else {
+      resume(tsp, maxIter + 1 - iter);              /// TS: stopping criteria (the search stops once iter > maxIter)
     }
+    bestSol = incumbent;
+    //bestSol = currSol;                            /// TS: not always the neighbor improves over 
+                                                    ///     the best available (incumbent) solution 
+    logLine("FINAL_SOLUTION");
+    logTour("", bestSol);
+    logLine("FINAL_VALUE ", bestValue);
+    log.close();                                                                                         
+  }
+  catch(std::exception& e)
+  {
+    std::cout << ">>>EXCEPTION: " << e.what() << std::endl;
+    return false;
+  }
+  
+  return true;
+}
 
-    // Initialize frequency matrix size and zero it
-    freq.clear();
-    freq.resize(tsp.n, std::vector<double>(tsp.n, 0.0));
+void TSPSolver::start ( const TSP& tsp , const TSPSolution& initSol )
+{
+  // debug arguments
+  logLine("Arguments: ");
+  logLine("alpha: ", alpha);
+  logLine("beta: ", beta);
+  logLine("decayFactor: ", decayFactor);
+  logLine("lambda: ", lambda);
+  logLine("----------------------------------------");
+
+  stopped = false;
+  iter = 0;
+
+  ///Tabu Search
+  tabuLength = std::max(5, tsp.n / 10);
+  tabuList.clear();
+  tabuList.reserve(tsp.n);
+  initTabuList(tsp.n);
+  ///
+  noImproveThreshold = static_cast<int>(alpha * tsp.n);
+  tenureAdaptThreshold = static_cast<int>(beta * noImproveThreshold);
+  shakeThreshold = noImproveThreshold;
+
+  if (shakeThreshold <= tenureAdaptThreshold) {
+    throw std::logic_error("shakeThreshold must be > tenureAdaptThreshold");
+  }
 
-    updateEliteSolutions(initSol, tsp);
-    
-    TSPSolution currSol(initSol);
-    double bestValue, currValue;
-    bestValue = currValue = evaluate(currSol,tsp);
+  // Initialize frequency matrix size and zero it (packed triangle for symmetric instances)
+  symmetricMode = tsp.symmetric;
+  freq.clear();
+  symFreq.clear();
+  if (symmetricMode) symFreq.resize(tsp.n, 0.0);
+  else freq.resize(tsp.n, std::vector<double>(tsp.n, 0.0));
+
+  initElitePool(tsp.n);
+  updateEliteSolutions(initSol, tsp);
+  
+  currSol = initSol;
+  incumbent = initSol;
+  bestValue = currValue = evaluate(currSol,tsp);
 
+  if ( verbose ) {
     std::cout << "Initial solution: ";
     currSol.print();
     std::cout << " (value : " << currValue << ")" << std::endl;
+  }
 
-    log << "TOUR ";
-    for (int city : currSol.sequence) log << city << " ";
-    log << "\nVALUE " << currValue << "\n";
-
-    TSPMove move;
-
-    const double epsilon = 0.01;
-    static int iterationsSinceImprovement = 0;
-    static bool tenureIncreased = false;
-    static int oldTenure = 0;
-    static int decay = decayInterval;
-
-    while ( ! stop ) {
-      ++iter;                                                                                             /// TS: iter not only for displaying
-      if ( tsp.n < 20 ) currSol.print();
-      log << "ITERATION " << iter << "\n";
-      log << "TOUR ";
-      for (int city : currSol.sequence) log << city << " ";
-      log << "\n";
-      log << "VALUE -> " << currValue << "\n";
-
-      // FREQUENCY PENALTY UPDATE
-      decay --;
-      if (tenureWasAdapted || decay <= 0) {
-        decay = decayInterval;
-        updateFrequencies(currSol);
-        tenureWasAdapted = false;
-      }
-      
-
-      double bestCostVariation = findBestNeighbor(tsp,currSol,iter,currValue,bestValue,move);
-      double printableVariation = std::abs(bestCostVariation) < 1e-10 ? 0.0 : bestCostVariation;
-      log << "BEST_COST_VARIATION " << printableVariation << "\n";
-      double bestNeighValue = currValue + bestCostVariation;                                            //**// TSAC: aspiration
-      //if ( bestNeighValue < currValue ) {         /// TS: replace stopping and moving criteria; SIMONE: too simple (it would stop too soon) -> do not use
-      //  bestValue = currValue = bestNeighValue;   ///
-      //  currSol = apply2optMove(currSol,move);    ///
-      //  stop = false;                             ///
-      //} else {                                    ///
-      //  stop = true;                              ///
-      //}                                           ///
-      
-      if ( bestNeighValue >= tsp.infinite ) {       /// TS: stop because all neighbours are tabu
-        std::cout << "\tmove: NO legal neighbour" << std::endl;   ///
-        log << "NO legal neighbour\n";
-        stop = true;                                ///
-        continue;                                   ///
-      }                                             ///
-      
-      std::cout << "\tmove: " << move.from << " , " << move.to;       // NEXT MOVE that we are going to apply after the current iteration
-      log << "MOVE " << move.from << " , " << move.to << "\n";
-      
-			updateTabuList(currSol.sequence[move.from],currSol.sequence[move.to],iter);	/// TS: insert move info into tabu list
-			      
-			currSol = apply2optMove(currSol,move);                                      /// TS: always the best move
-      currValue = bestNeighValue;
-      oldTenure = tabuLength;
-
-      log << "currValue " << currValue << " bestValue " << bestValue << "\n";
-      if ( currValue < bestValue - epsilon ) {					/// TS: update incumbent (if better -with tolerance- solution found)
-        bestValue = currValue;
-        bestSol = currSol;
-        std::cout << "\t***";
-        log << "NEW INCUMBENT accepted -> " << bestValue << "\n";
-        updateEliteSolutions(currSol, tsp);                       // Maybe insert the current solution into elite solutions
-        iterationsSinceImprovement = 0;
-        tenureIncreased = false;
+  logTour("TOUR ", currSol);
+  logLine("VALUE ", currValue);
 
-        // --- INTENSIFICATION: reduce tenure --
-        tabuLength = std::max(minTenure, tabuLength / 2);
-        log << "\t*** (intensification, tenure: " << oldTenure << " -> " << tabuLength << ")\n";
+  // search state (members, so that every solve starts afresh and solvers can run in parallel)
+  iterationsSinceImprovement = 0;
+  tenureIncreased = false;
+  tenureWasAdapted = false;
+  oldTenure = 0;
+  decay = decayInterval;
+}
 
-      } else {
-        iterationsSinceImprovement++;
+bool TSPSolver::resume ( const TSP& tsp , int iterations )
+{
+  TSPMove move = { 0 , 0 , 0.0 };
+
+  const double epsilon = 0.01;
+  const int lastIter = iter + iterations;
+
+  while ( ! stopped && iter < lastIter ) {
+    ++iter;                                                                                             /// TS: iter not only for displaying
+    if ( instr ) instr->count(Instrumentation::ITERATIONS);
+    if ( verbose && tsp.n < 20 ) currSol.print();
+    logLine("ITERATION ", iter);
+    logTour("TOUR ", currSol);
+    logLine("VALUE -> ", currValue);
+
+    // FREQUENCY PENALTY UPDATE
+    decay --;
+    if (tenureWasAdapted || decay <= 0) {
+      ScopedTimer timer(instr, Instrumentation::FREQUENCY_UPDATE);
+      decay = decayInterval;
+      updateFrequencies(currSol);
+      tenureWasAdapted = false;
+    }
+    
 
-        // --- DIVERSIFICATION: increase tenure if no improvement for a while ---
-        log << "\t NO IMPROVEMENT; Iteration since improvement=" << iterationsSinceImprovement << " tenure=" << tabuLength << " tenureAdaptThreshold=" << tenureAdaptThreshold << " shakeThreshold=" << shakeThreshold << "\n";
-        if (iterationsSinceImprovement >= tenureAdaptThreshold && !tenureIncreased) {
-          tabuLength = std::min(maxTenure, tabuLength * 2);
-          tenureIncreased = true;
-          log << "\t(diversification, tenure: " << oldTenure << " -> " << tabuLength << ")\n";
-          tenureWasAdapted = true;
-        }
+    double bestCostVariation;
+    {
+      ScopedTimer timer(instr, Instrumentation::NEIGHBORHOOD_SCAN);
+      bestCostVariation = findBestNeighbor(tsp,currSol,iter,currValue,bestValue,move);
+    }
+    double printableVariation = std::abs(bestCostVariation) < 1e-10 ? 0.0 : bestCostVariation;
+    logLine("BEST_COST_VARIATION ", printableVariation);
+    double bestNeighValue = currValue + move.delta;                                                  //**// TSAC: aspiration
+    //if ( bestNeighValue < currValue ) {         /// TS: replace stopping and moving criteria; SIMONE: too simple (it would stop too soon) -> do not use
+    //  bestValue = currValue = bestNeighValue;   ///
+    //  currSol = apply2optMove(currSol,move);    ///
+    //  stop = false;                             ///
+    //} else {                                    ///
+    //  stop = true;                              ///
+    //}                                           ///
+    
+    if ( bestCostVariation >= tsp.infinite ) {    /// TS: stop because all neighbours are tabu
+      if ( verbose ) std::cout << "\tmove: NO legal neighbour" << std::endl;   ///
+      logLine("NO legal neighbour");
+      stopped = true;                             ///
+      continue;                                   ///
+    }                                             ///
+    
+    if ( verbose ) std::cout << "\tmove: " << move.from << " , " << move.to;       // NEXT MOVE that we are going to apply after the current iteration
+    logLine("MOVE ", move.from, " , ", move.to);
+    
+    updateTabuList(currSol.sequence[move.from],currSol.sequence[move.to],iter);	/// TS: insert move info into tabu list
+          
+    {
+      ScopedTimer timer(instr, Instrumentation::MOVE_APPLICATION);
+      currSol = apply2optMove(currSol,move);                                    /// TS: always the best move
+    }
+    currValue = bestNeighValue;
+    oldTenure = tabuLength;
+
+    logLine("currValue ", currValue, " bestValue ", bestValue);
+    if ( currValue < bestValue - epsilon ) {					/// TS: update incumbent (if better -with tolerance- solution found)
+      bestValue = currValue;
+      incumbent = currSol;
+      if ( verbose ) std::cout << "\t***";
+      if ( instr ) {
+        instr->count(Instrumentation::IMPROVEMENTS);
+        instr->incumbent(bestValue);
+      }
+      logLine("NEW INCUMBENT accepted -> ", bestValue);
+      updateEliteSolutions(currSol, tsp);                       // Maybe insert the current solution into elite solutions
+      iterationsSinceImprovement = 0;
+      tenureIncreased = false;
+
+      // --- INTENSIFICATION: reduce tenure --
+      tabuLength = std::max(minTenure, tabuLength / 2);
+      logLine("\t*** (intensification, tenure: ", oldTenure, " -> ", tabuLength, ")");
+
+      if ( targetValue >= 0 && bestValue <= targetValue ) {   /// early termination: close enough to the lower bound
+        logLine("TARGET reached (", targetValue, ")");
+        stopped = true;
+      }
 
-        if (iterationsSinceImprovement >= shakeThreshold) {
-          bool useElite = (!eliteSolutions.empty() && rand() % 2 == 0);
-
-          if (useElite) {
-            // --- ELITE INTENSIFICATION: Restart from one of the best solutions
-            currSol = eliteSolutions[rand() % eliteSolutions.size()].sol;
-            currValue = evaluate(currSol, tsp);
-            log << "\t shakeThreshold " << shakeThreshold << "\n";
-            log << "\t(Elite intensification: restarting from elite)\n";
-            std::cout << "\t Intensification: restarting from elite solution" << std::endl;
-          } else {
-            // --- DIVERSIFICATION: Double-bridge shaking
-            currSol = applyDoubleBridgeMove(currSol);
-            currValue = evaluate(currSol, tsp);
-            log << "\t shakeThreshold " << shakeThreshold << "\n";
-            log << "\t(shaking applied: double-bridge move)\n";
-            std::cout << "\t Shaking: double-bridge move applied" << std::endl;
-          }
-
-          iterationsSinceImprovement = 0;
-          tenureIncreased = false;
+    } else {
+      iterationsSinceImprovement++;
+
+      // --- DIVERSIFICATION: increase tenure if no improvement for a while ---
+      logLine("\t NO IMPROVEMENT; Iteration since improvement=", iterationsSinceImprovement, " tenure=", tabuLength,
+              " tenureAdaptThreshold=", tenureAdaptThreshold, " shakeThreshold=", shakeThreshold);
+      if (iterationsSinceImprovement >= tenureAdaptThreshold && !tenureIncreased) {
+        tabuLength = std::min(maxTenure, tabuLength * 2);
+        tenureIncreased = true;
+        logLine("\t(diversification, tenure: ", oldTenure, " -> ", tabuLength, ")");
+        tenureWasAdapted = true;
+      }
+
+      if (iterationsSinceImprovement >= shakeThreshold) {
+        bool useElite = (eliteCount > 0 && rng() % 2 == 0);
+
+        if (useElite) {
+          // --- ELITE INTENSIFICATION: Restart from one of the best solutions
+          currSol = eliteSolutions[rng() % eliteCount].sol;     // copied into currSol's own buffer
+          currValue = evaluate(currSol, tsp);
+          if ( instr ) instr->count(Instrumentation::ELITE_RESTARTS);
+          logLine("\t shakeThreshold ", shakeThreshold);
+          logLine("\t(Elite intensification: restarting from elite)");
+          if ( verbose ) std::cout << "\t Intensification: restarting from elite solution" << std::endl;
+        } else {
+          // --- DIVERSIFICATION: Double-bridge shaking
+          applyDoubleBridgeMove(currSol);
+          currValue = evaluate(currSol, tsp);
+          if ( instr ) instr->count(Instrumentation::SHAKES);
+          logLine("\t shakeThreshold ", shakeThreshold);
+          logLine("\t(shaking applied: double-bridge move)");
+          if ( verbose ) std::cout << "\t Shaking: double-bridge move applied" << std::endl;
         }
+
+        iterationsSinceImprovement = 0;
+        tenureIncreased = false;
       }
-      
-      if ( iter > maxIter ) {                       /// TS: new stopping criteria
-        stop = true;                                ///
-      }                                             ///
-      std::cout << std::endl;
     }
-    //bestSol = currSol;                            /// TS: not always the neighbor improves over 
-                                                    ///     the best available (incumbent) solution 
-    log << "FINAL_SOLUTION\n";
-    for (int city : bestSol.sequence) log << city << " ";
-    log << "\n";
-    log << "FINAL_VALUE " << bestValue << "\n";
-    log.close();                                                                                         
-  }
-  catch(std::exception& e)
-  {
-    std::cout << ">>>EXCEPTION: " << e.what() << std::endl;
-    return false;
+    
+    if ( verbose ) std::cout << std::endl;
   }
-  
-  return true;
+  return !stopped;
 }
 
 TSPSolution& TSPSolver::apply2optMove ( TSPSolution& tspSol , const TSPMove& move ) 
 {
-  TSPSolution tmpSol(tspSol);
-  for ( int i = move.from ; i <= move.to ; ++i ) {
-    tspSol.sequence[i] = tmpSol.sequence[move.to-(i-move.from)];
-  }
+  std::reverse(tspSol.sequence.begin() + move.from, tspSol.sequence.begin() + move.to + 1);   // in place
   return tspSol;
 }
 
-double TSPSolver::findBestNeighbor ( const TSP& tsp , const TSPSolution& currSol , int currIter , double currValue, double bestValue , TSPMove& move )     //**// TSAC: use aspiration
+template <class Cost, class Freq>
+double TSPSolver::scanNeighborhood ( const Cost& cost , const Freq& freqAt , const TSP& tsp , const TSPSolution& currSol , int currIter , double currValue, double bestValue , TSPMove& move )
 /* Determine the NON-TABU *move* yielding the best 2-opt neigbor solution 
  * Aspiration criteria: 'neighCostVariation' better than 'aspiration' (notice that 'aspiration'
  * has been set such that if 'neighCostVariation' is better than 'aspiration' than we have a
@@ -196,6 +245,7 @@ double TSPSolver::findBestNeighbor ( const TSP& tsp , const TSPSolution& currSol
 {
   //logLine("entering\n");
   double bestCostVariation = tsp.infinite; // the change in total tour cost if we apply a 2-opt move
+  long evaluated = 0, blocked = 0, aspirations = 0;   // instrumentation (added once per scan)
 
   // h, i, j, l are node indices for a possible 2-opt move:
   // h = node before the segment (currSol.sequence[a-1])
@@ -211,13 +261,14 @@ double TSPSolver::findBestNeighbor ( const TSP& tsp , const TSPSolution& currSol
     for ( uint b = a + 1 ; b < currSol.sequence.size() - 1 ; b++ ) {
       int j = currSol.sequence[b];
       int l = currSol.sequence[b+1];
-      double freqPenalty = lambda * (freq[i][j] + freq[h][i] + freq[j][l]);
+      double freqPenalty = lambda * (freqAt(i, j) + freqAt(h, i) + freqAt(j, l));
 			//**// TSAC: to be checked after... if (isTabu(i,j,currIter)) continue;						/// TS: tabu check (just one among many ways of doing it...) 
-      double neighCostVariation = - tsp.cost[h][i] - tsp.cost[j][l]
-                                  + tsp.cost[h][j] + tsp.cost[i][l]
+      double neighCostVariation = - cost(h, i) - cost(j, l)
+                                  + cost(h, j) + cost(i, l)
                                   + freqPenalty;
 
-      double newValue = currValue + neighCostVariation;
+      double newValue = currValue + neighCostVariation - freqPenalty;   // tour length after the move
+      ++evaluated;
       bool tabu = isTabu(i, j, currIter);
       bool aspirationOk = newValue < bestValue - 0.01;
 
@@ -228,16 +279,14 @@ double TSPSolver::findBestNeighbor ( const TSP& tsp , const TSPSolution& currSol
       // << "  isTabu=" << (tabu ? "YES" : "NO")
       // << (tabu && aspirationOk ? " (ASPIRATION)\n" : "\n");
 
+      // no log output in the scan: blocked moves and aspirations are only counted
       if (tabu && !aspirationOk) {
-          log << "[TABU BLOCKED] i=" << i << " j=" << j
-          << "  variation=" << neighCostVariation
-          << " → new value = " << newValue
-          << " not < bestValue = " << bestValue << "\n";
+          ++blocked;
           continue;
       }
 
       if (tabu && aspirationOk) {
-          log << "ASPIRATION ACCEPTED";
+          ++aspirations;
       }
 
       //log << "-> inside: " << bestCostVariation << " " << neighCostVariation << "\n";
@@ -245,6 +294,7 @@ double TSPSolver::findBestNeighbor ( const TSP& tsp , const TSPSolution& currSol
         bestCostVariation = neighCostVariation;
         move.from = a;
         move.to = b;
+        move.delta = neighCostVariation - freqPenalty;
       }
       // if it stays = tsp.infinite, it means that the move is not improving the tour
 
@@ -254,38 +304,70 @@ double TSPSolver::findBestNeighbor ( const TSP& tsp , const TSPSolution& currSol
       //So as soon as you find a move that improves the tour, just stop searching and return it immediately.
     }
   }
+  if ( instr ) {
+    instr->count(Instrumentation::MOVES_EVALUATED, evaluated);
+    instr->count(Instrumentation::TABU_BLOCKED, blocked);
+    instr->count(Instrumentation::ASPIRATION_ACCEPTED, aspirations);
+  }
   return bestCostVariation;
 }
 
-TSPSolution TSPSolver::applyDoubleBridgeMove(const TSPSolution& sol) {
-    TSPSolution newSol(sol);
-    int n = newSol.sequence.size();
+double TSPSolver::findBestNeighbor ( const TSP& tsp , const TSPSolution& currSol , int currIter , double currValue, double bestValue , TSPMove& move )     //**// TSAC: use aspiration
+/* Dispatch the neighbourhood scan on the storage of the instance, so that the inner loop
+ * reads distances and frequencies without any run-time check
+ */
+{
+  if ( tsp.gridDistances ) {
+    return withMetric(tsp.metric, [&]( auto policy ) {
+      return findBestGridNeighbor<decltype(policy)>(tsp, currSol, currIter, currValue, bestValue, move);
+    });
+  }
+  if ( tsp.symmetric ) {
+    return scanNeighborhood([&tsp]( int i , int j ) { return tsp.symCost(i, j); },
+                            [this]( int i , int j ) { return symFreq(i, j); },
+                            tsp, currSol, currIter, currValue, bestValue, move);
+  }
+  return scanNeighborhood([&tsp]( int i , int j ) { return tsp.cost[i][j]; },
+                          [this]( int i , int j ) { return freq[i][j]; },
+                          tsp, currSol, currIter, currValue, bestValue, move);
+}
+
+template <class Metric>
+double TSPSolver::findBestGridNeighbor ( const TSP& tsp , const TSPSolution& currSol , int currIter , double currValue, double bestValue , TSPMove& move )
+/* Neighbourhood scan without cost matrix, instantiated per metric policy: sqrt-based metrics read
+ * the grid table, the others are computed from the coordinate differences in the loop
+ */
+{
+  const GridDistanceTable& table = tsp.gridTable;
+  const std::vector<std::pair<int, int>>& holes = tsp.holes;
+  auto cost = [&table, &holes]( int i , int j ) {
+    int dx = holes[i].first - holes[j].first, dy = holes[i].second - holes[j].second;
+    if ( Metric::tabulated ) return table(dx, dy);
+    return Metric::distance(dx, dy);
+  };
+  if ( tsp.symmetric ) {
+    return scanNeighborhood(cost, [this]( int i , int j ) { return symFreq(i, j); },
+                            tsp, currSol, currIter, currValue, bestValue, move);
+  }
+  return scanNeighborhood(cost, [this]( int i , int j ) { return freq[i][j]; },
+                          tsp, currSol, currIter, currValue, bestValue, move);
+}
+
+void TSPSolver::applyDoubleBridgeMove(TSPSolution& sol) {
+    int n = sol.sequence.size();
 
     // Ensure there are enough cities to perform the move
-    if (n < 8) return newSol;
-
-    // Select four break points ensuring they are in order and not too close
-    int pos1 = 1 + rand() % (n / 4);
-    int pos2 = pos1 + 1 + rand() % (n / 4);
-    int pos3 = pos2 + 1 + rand() % (n / 4);
-    int pos4 = pos3 + 1 + rand() % (n / 4);
-
-    // Create segments
-    std::vector<int> segment1(newSol.sequence.begin(), newSol.sequence.begin() + pos1);
-    std::vector<int> segment2(newSol.sequence.begin() + pos1, newSol.sequence.begin() + pos2);
-    std::vector<int> segment3(newSol.sequence.begin() + pos2, newSol.sequence.begin() + pos3);
-    std::vector<int> segment4(newSol.sequence.begin() + pos3, newSol.sequence.begin() + pos4);
-    std::vector<int> segment5(newSol.sequence.begin() + pos4, newSol.sequence.end());
-
-    // Reconnect segments in new order: segment1 + segment3 + segment2 + segment4 + segment5
-    newSol.sequence.clear();
-    newSol.sequence.insert(newSol.sequence.end(), segment1.begin(), segment1.end()); // Appending the contents of segment1 to the end of newSol.sequence
-    newSol.sequence.insert(newSol.sequence.end(), segment3.begin(), segment3.end());
-    newSol.sequence.insert(newSol.sequence.end(), segment2.begin(), segment2.end());
-    newSol.sequence.insert(newSol.sequence.end(), segment4.begin(), segment4.end());
-    newSol.sequence.insert(newSol.sequence.end(), segment5.begin(), segment5.end());
-
-    return newSol;
+    if (n < 8) return;
+
+    // Select break points ensuring they are in order and not too close
+    int pos1 = 1 + rng() % (n / 4);
+    int pos2 = pos1 + 1 + rng() % (n / 4);
+    int pos3 = pos2 + 1 + rng() % (n / 4);
+    rng();  // fourth break point: segment4 + segment5 keep their place, still drawn for the same random sequence
+
+    // Reconnect segments in new order: segment1 + segment3 + segment2 + segment4 + segment5,
+    // i.e. swap the adjacent segments 2 and 3 in place (no temporary segments)
+    std::rotate(sol.sequence.begin() + pos1, sol.sequence.begin() + pos2, sol.sequence.begin() + pos3);
 }
 
 void TSPSolver::updateFrequencies(const TSPSolution& sol) {
@@ -293,27 +375,183 @@ void TSPSolver::updateFrequencies(const TSPSolution& sol) {
     for (int k = 0; k < n; ++k) {
         int a = sol.sequence[k];
         int b = sol.sequence[k + 1];
-        freq[a][b] += decayFactor;
+        if (symmetricMode) symFreq(a, b) += decayFactor;
+        else freq[a][b] += decayFactor;
     }
 }
 
+void TSPSolver::initElitePool(int n) {
+    eliteSolutions.resize(eliteSize);
+    for (ScoredSolution& e : eliteSolutions) {
+        e.sol.sequence.clear();
+        e.sol.sequence.reserve(n + 1);  // tours are copied into the slots, never reallocated
+        e.score = 0.0;
+    }
+    eliteCount = 0;
+    worstElite = 0;
+}
+
 void TSPSolver::updateEliteSolutions(const TSPSolution& currSol, const TSP& tsp) {
     double currScore = evaluate(currSol, tsp);
 
-    // If not yet full, just insert
-    if (eliteSolutions.size() < eliteSize) {
-        eliteSolutions.push_back({currSol, currScore});
-        return;
+    // If not yet full, fill the next slot; otherwise replace the worst if current is better
+    size_t slot = eliteCount;
+    if (eliteCount == eliteSize) {
+        if (currScore >= eliteSolutions[worstElite].score) return;
+        slot = worstElite;
+    } else {
+        ++eliteCount;
     }
+    eliteSolutions[slot].sol.sequence.assign(currSol.sequence.begin(), currSol.sequence.end());
+    eliteSolutions[slot].score = currScore;
+
+    // Find the new worst — the first slot with maximum score (value)
+    if (eliteCount == eliteSize) {
+        worstElite = 0;
+        for (size_t k = 1; k < eliteCount; ++k) {
+            if (eliteSolutions[k].score > eliteSolutions[worstElite].score) worstElite = k;
+        }
+    }
+}
+
+static const char CHECKPOINT_MAGIC[8] = {'T', 'S', 'P', 'C', 'K', 'P', 'T', '1'};
 
-    // Find the worst — the element with maximum score (value)
-    auto worstIt = std::max_element(eliteSolutions.begin(), eliteSolutions.end(),
-        [](const ScoredSolution& a, const ScoredSolution& b) {
-            return a.score < b.score;
-        });
+/** content hash of the instance a search state belongs to */
+static uint64_t instanceHash ( const TSP& tsp )
+{
+  std::vector<Hole> holes(tsp.holes.size());
+  for ( size_t i = 0 ; i < holes.size() ; ++i ) holes[i] = Hole{tsp.holes[i].first, tsp.holes[i].second};
+  uint64_t hash = boardHash(tsp.gridSize, holes.data(), holes.size());
+  // other metrics give other instances (Euclidean keeps the plain board hash of older checkpoints)
+  return tsp.metric == METRIC_EUCLIDEAN ? hash : hash ^ ( 0x9e3779b97f4a7c15ULL * tsp.metric );
+}
 
-    // Replace worst if current is better
-    if (currScore < worstIt->score) {
-        *worstIt = {currSol, currScore};
+void TSPSolver::setCheckpoint ( const std::string& path , int interval )
+{
+  checkpointWriter.reset();                         // flushes a previous writer
+  checkpointInterval = path.empty() ? 0 : interval;
+  if ( checkpointInterval > 0 ) checkpointWriter.reset(new CheckpointWriter(path));
+}
+
+void TSPSolver::saveState ( const TSP& tsp , std::vector<char>& out ) const
+{
+  CheckpointBuffer buf;
+  buf.bytes.swap(out);
+  buf.bytes.clear();
+  buf.putRaw(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+  buf.put<uint64_t>(instanceHash(tsp));
+  buf.put<int32_t>(tsp.n);
+  buf.put<int32_t>(symmetricMode);
+
+  buf.put(alpha); buf.put(beta); buf.put(decayFactor); buf.put(lambda);
+  buf.put(targetValue);
+  buf.put<int32_t>(iter);
+  buf.put<int32_t>(stopped);
+  buf.put<int32_t>(tabuLength);
+  buf.put<int32_t>(oldTenure);
+  buf.put<int32_t>(decay);
+  buf.put<int32_t>(iterationsSinceImprovement);
+  buf.put<int32_t>(tenureIncreased);
+  buf.put<int32_t>(tenureWasAdapted);
+  buf.put<int32_t>(noImproveThreshold);
+  buf.put<int32_t>(tenureAdaptThreshold);
+  buf.put<int32_t>(shakeThreshold);
+  buf.put(currValue);
+  buf.put(bestValue);
+  buf.putVector(currSol.sequence);
+  buf.putVector(incumbent.sequence);
+  buf.putVector(tabuList);
+
+  if ( symmetricMode ) {
+    for ( int i = 0 ; i < tsp.n ; ++i ) buf.putRaw(&symFreq(i, 0), ( i + 1 ) * sizeof(double));   // packed rows
+  } else {
+    for ( int i = 0 ; i < tsp.n ; ++i ) buf.putRaw(freq[i].data(), tsp.n * sizeof(double));
+  }
+
+  buf.put<uint64_t>(eliteCount);
+  for ( size_t k = 0 ; k < eliteCount ; ++k ) {
+    buf.put(eliteSolutions[k].score);
+    buf.putVector(eliteSolutions[k].sol.sequence);
+  }
+
+  std::ostringstream rngState;                      // the standard textual state of mt19937
+  rngState << rng;
+  buf.putString(rngState.str());
+  out.swap(buf.bytes);
+}
+
+bool TSPSolver::restoreState ( const TSP& tsp , const std::vector<char>& in )
+{
+  try {
+    CheckpointReader r(in.data(), in.size());
+    char magic[8];
+    r.getRaw(magic, sizeof(magic));
+    if ( memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 ) throw std::runtime_error("not a checkpoint");
+    if ( r.get<uint64_t>() != instanceHash(tsp) || r.get<int32_t>() != tsp.n ) {
+      throw std::runtime_error("checkpoint of another instance");
+    }
+    symmetricMode = r.get<int32_t>();
+    if ( symmetricMode != tsp.symmetric ) throw std::runtime_error("checkpoint of a run with another --symmetric setting");
+
+    alpha = r.get<double>(); beta = r.get<double>(); decayFactor = r.get<double>(); lambda = r.get<double>();
+    targetValue = r.get<double>();
+    iter = r.get<int32_t>();
+    stopped = r.get<int32_t>();
+    tabuLength = r.get<int32_t>();
+    oldTenure = r.get<int32_t>();
+    decay = r.get<int32_t>();
+    iterationsSinceImprovement = r.get<int32_t>();
+    tenureIncreased = r.get<int32_t>();
+    tenureWasAdapted = r.get<int32_t>();
+    noImproveThreshold = r.get<int32_t>();
+    tenureAdaptThreshold = r.get<int32_t>();
+    shakeThreshold = r.get<int32_t>();
+    currValue = r.get<double>();
+    bestValue = r.get<double>();
+    r.getVector(currSol.sequence);
+    r.getVector(incumbent.sequence);
+    r.getVector(tabuList);
+
+    freq.clear();
+    symFreq.clear();
+    if ( symmetricMode ) {
+      symFreq.resize(tsp.n, 0.0);
+      for ( int i = 0 ; i < tsp.n ; ++i ) r.getRaw(&symFreq(i, 0), ( i + 1 ) * sizeof(double));
+    } else {
+      freq.assign(tsp.n, std::vector<double>(tsp.n, 0.0));
+      for ( int i = 0 ; i < tsp.n ; ++i ) r.getRaw(freq[i].data(), tsp.n * sizeof(double));
     }
+
+    uint64_t elites = r.get<uint64_t>();
+    if ( elites > eliteSize ) throw std::runtime_error("malformed checkpoint");
+    initElitePool(tsp.n);
+    for ( ; eliteCount < elites ; ++eliteCount ) {
+      eliteSolutions[eliteCount].score = r.get<double>();
+      r.getVector(eliteSolutions[eliteCount].sol.sequence);
+    }
+    for ( size_t k = 1 ; k < eliteCount ; ++k ) {
+      if ( eliteSolutions[k].score > eliteSolutions[worstElite].score ) worstElite = k;
+    }
+
+    std::istringstream rngState(r.getString());
+    rngState >> rng;
+    if ( !rngState || !r.atEnd() ) throw std::runtime_error("malformed checkpoint");
+  } catch ( std::exception& e ) {
+    std::cerr << "Cannot restore the search state: " << e.what() << std::endl;
+    return false;
+  }
+  restored = true;
+  return true;
+}
+
+bool TSPSolver::loadCheckpoint ( const std::string& path , const TSP& tsp )
+{
+  std::vector<char> bytes;
+  if ( !CheckpointWriter::readFile(path, bytes) ) {
+    std::cerr << "Cannot read checkpoint: " << path << std::endl;
+    return false;
+  }
+  if ( !restoreState(tsp, bytes) ) return false;
+  logLine("RESUMED from ", path, " at iteration ", iter, " (value ", bestValue, ")");
+  return true;
 }
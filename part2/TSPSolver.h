@@ -9,8 +9,13 @@
 
 #include <vector>
 #include <algorithm>
+#include <random>
+#include <ctime>
+#include <memory>
 
 #include "TSPSolution.h"
+#include "Checkpoint.h"
+#include "Instrumentation.h"
 
 /**
  * Class representing substring reversal move
@@ -18,6 +23,7 @@
 typedef struct move {
   int      from;
   int      to;
+  double   delta;   // tour length variation of the move (without the frequency penalty)
 } TSPMove;
 
 struct ScoredSolution {
@@ -35,51 +41,126 @@ public:
   TSPSolver ( ) { }
 
   TSPSolver ( const std::string& logFileName = "tsp_log.txt" , double alpha = 0.75 , double beta = 0.5 , double decayFactor = 0.9 , double lambda = 0.01 ) :
-    alpha(alpha), beta(beta), decayFactor(decayFactor), lambda(lambda) {
+    alpha(alpha), beta(beta), decayFactor(decayFactor), lambda(lambda), rng(time(NULL)) {
+    if (logFileName.empty()) return;   // no log (e.g. many solvers running in parallel)
     log.open(logFileName);
     if (!log) {
       std::cerr << "Error opening log file: " << logFileName << std::endl;
     }
   }
 
+  /** seed the solver's own random generator (random initial tour, shaking, elite restarts) */
+  void setSeed ( unsigned int seed ) { rng.seed(seed); }
+
+  /** enable/disable the per-iteration trace on stdout */
+  void setVerbose ( bool v ) { verbose = v; }
+
   double evaluate ( const TSPSolution& sol , const TSP& tsp ) const {
     double total = 0.0;
     for ( uint i = 0 ; i < sol.sequence.size() - 1 ; ++i ) {
       int from = sol.sequence[i]  ;
       int to   = sol.sequence[i+1];
-      total += tsp.cost[from][to];
+      total += tsp.dist(from, to);
     }
 
     // return to initial node
-    total += tsp.cost[sol.sequence.back()][sol.sequence.front()];
+    total += tsp.dist(sol.sequence.back(), sol.sequence.front());
 
     return total;
   }
 
   bool initRnd ( TSPSolution& sol ) {
-    srand(time(NULL));
     for ( uint i = 1 ; i < sol.sequence.size() ; ++i ) {
       // intial and final position are fixed (initial/final node remains 0)
-      int idx1 = rand() % (sol.sequence.size()-2) + 1;
-      int idx2 = rand() % (sol.sequence.size()-2) + 1;
+      int idx1 = rng() % (sol.sequence.size()-2) + 1;
+      int idx2 = rng() % (sol.sequence.size()-2) + 1;
       int tmp = sol.sequence[idx1];
       sol.sequence[idx1] = sol.sequence[idx2];
       sol.sequence[idx2] = tmp;
     }
-    std::cout << "### "; sol.print(); std::cout << " ###" << std::endl;
+    if ( verbose ) { std::cout << "### "; sol.print(); std::cout << " ###" << std::endl; }
     return true;
   }
 
   bool solve ( const TSP& tsp , const TSPSolution& initSol , int tabulength , int maxIter , TSPSolution& bestSol); /// TS: new parameters
 
+  /** budgeted search: initialize the search state from a starting tour (solve = start + resume)
+  * @param tsp TSP instance
+  * @param initSol starting tour
+  */
+  void start ( const TSP& tsp , const TSPSolution& initSol );
+  /** budgeted search: continue the search for (at most) a given number of iterations
+  * @param tsp TSP instance (the one passed to start)
+  * @param iterations iteration budget
+  * @return false if the search has stopped (no legal neighbour, target reached)
+  */
+  bool resume ( const TSP& tsp , int iterations );
+  const TSPSolution& getIncumbent ( ) const { return incumbent; }
+  /** length of the incumbent tour (the frequency penalties only steer the choice of the moves) */
+  double getIncumbentValue ( ) const { return bestValue; }
+  int    getIteration ( ) const { return iter; }
+  /** elite pool of the search (best tours met, with their values) */
+  std::vector<ScoredSolution> getEliteSolutions ( ) const {
+    return std::vector<ScoredSolution>(eliteSolutions.begin(), eliteSolutions.begin() + eliteCount);
+  }
+
+  /** early termination: stop as soon as the incumbent value is <= target
+  * (e.g. a lower bound increased by the accepted optimality gap)
+  * @param target target value (< 0: disabled)
+  */
+  void setTargetValue ( double target ) { targetValue = target; }
+
+  /** attach counters and phase timers to the search (nullptr: disabled, the default)
+  * @param instrumentation owned by the caller, must outlive the searches it records
+  */
+  void setInstrumentation ( Instrumentation* instrumentation ) { instr = instrumentation; }
+
+  /** periodic checkpoints of solve(): every 'interval' iterations the complete search state
+  * (tours, tabu list, tenure, frequencies, elite pool, counters, parameters, random generator)
+  * is snapshotted and written to 'path' by a background thread
+  * @param path checkpoint file (replaced atomically at every write)
+  * @param interval iterations between checkpoints (<= 0: disabled)
+  */
+  void setCheckpoint ( const std::string& path , int interval );
+  /** restore a search state from a checkpoint file: the next solve() continues that search
+  * (bit-exactly: same moves, same random draws) up to its iteration budget instead of starting
+  * from initSol; the tabu parameters are those of the checkpointed run
+  * @param path checkpoint file
+  * @param tsp TSP instance (must be the instance of the checkpointed run)
+  * @return false (with a message on stderr) if the file is unreadable or belongs to another instance
+  */
+  bool loadCheckpoint ( const std::string& path , const TSP& tsp );
+  /** serialize the current search state (what setCheckpoint writes)
+  * @param tsp TSP instance
+  * @param out snapshot bytes
+  */
+  void saveState ( const TSP& tsp , std::vector<char>& out ) const;
+  /** restore a serialized search state
+  * @return false if the snapshot is malformed or belongs to another instance
+  */
+  bool restoreState ( const TSP& tsp , const std::vector<char>& in );
+
 protected:
   double    findBestNeighbor ( const TSP& tsp , const TSPSolution& currSol , int currIter , double currValue, double bestValue, TSPMove& move );	//**// TSAC: use aspiration!
+  template <class Metric>
+  double    findBestGridNeighbor ( const TSP& tsp , const TSPSolution& currSol , int currIter , double currValue, double bestValue, TSPMove& move );
+  template <class Cost, class Freq>
+  double    scanNeighborhood ( const Cost& cost , const Freq& freqAt , const TSP& tsp , const TSPSolution& currSol , int currIter , double currValue, double bestValue, TSPMove& move );
   TSPSolution&  apply2optMove        ( TSPSolution& tspSol , const TSPMove& move );
-  void logLine(const std::string& line) {
-    if (log.is_open()) {
-      log << line << "\n";
-      log.flush();
-    }
+  /** write one log line (its parts streamed in order), timed as LOGGING; nothing is formatted without a log */
+  template <class... Parts>
+  void logLine ( const Parts&... parts ) {
+    if ( !log.is_open() ) return;
+    ScopedTimer timer(instr, Instrumentation::LOGGING);
+    ( log << ... << parts ) << "\n";
+  }
+  /** write a tour as one log line, after a label */
+  void logTour ( const char* label , const TSPSolution& sol ) {
+    if ( !log.is_open() ) return;
+    ScopedTimer timer(instr, Instrumentation::LOGGING);
+    log << label;
+    for ( int city : sol.sequence ) log << city << " ";
+    log << "\n";
   }
   
   ///Tabu search (tabu list stores, for each node, when (last iteration) a move involving that node have been chosen)
@@ -91,12 +172,33 @@ protected:
   double alpha = 0.75;  // affects overall stagnation threshold                   // TO TUNE
   double beta = 0.5;    // ratio for tenure adaptation                            // TO TUNE
   const int decayInterval = 100;                  
-  const double decayFactor = 0.9;                                                 // TO TUNE
-  const double lambda = 0.01; // penalty factor for frequency-based tabu search   // TO TUNE
+  double decayFactor = 0.9;                                                       // TO TUNE
+  double lambda = 0.01; // penalty factor for frequency-based tabu search         // TO TUNE
   const size_t eliteSize = 10; // number of elite solutions to keep
+  double targetValue = -1.0;    // stop when the incumbent reaches this value (< 0: disabled)
   bool tenureWasAdapted = false;
+  int  iterationsSinceImprovement = 0;
+  bool tenureIncreased = false;
+  int  oldTenure = 0;
+  int  decay = decayInterval;
+  bool verbose = true;
+  TSPSolution currSol;         // current tour
+  TSPSolution incumbent;       // best tour found so far
+  double currValue = 0.0;       // tour lengths (without the frequency penalties)
+  double bestValue = 0.0;
+  int  iter = 0;
+  bool stopped = false;
+  bool restored = false;       // state loaded from a checkpoint: solve() skips start()
+  int  noImproveThreshold = 0;
+  int  tenureAdaptThreshold = 0;
+  int  shakeThreshold = 0;
+  std::mt19937 rng;
   std::vector<std::vector<double>> freq;
-  std::vector<ScoredSolution> eliteSolutions;
+  SymMatrix<double> symFreq;   // frequencies of symmetric instances (freq stays empty)
+  bool symmetricMode = false;
+  std::vector<ScoredSolution> eliteSolutions;   // eliteSize slots, tours preallocated by start: the first eliteCount are in use
+  size_t eliteCount = 0;
+  size_t worstElite = 0;       // slot replaced by the next better tour once the pool is full (highest score)
   std::vector<int>  tabuList;
   void  initTabuList ( int n ) {
     for ( int i = 0 ; i < n ; ++i ) {
@@ -111,10 +213,15 @@ protected:
 	bool isTabu( int nodeFrom, int nodeTo , int iter ) {
 		return ( (iter - tabuList[nodeFrom] <= tabuLength) && (iter - tabuList[nodeTo] <= tabuLength) );
   }
-  TSPSolution applyDoubleBridgeMove(const TSPSolution& sol);
+  void applyDoubleBridgeMove(TSPSolution& sol);
   void updateFrequencies(const TSPSolution& sol);
+  void initElitePool(int n);
   void updateEliteSolutions(const TSPSolution& currSol, const TSP& tsp);
 
+  std::unique_ptr<CheckpointWriter> checkpointWriter;
+  Instrumentation* instr = nullptr;   // counters and timers (nullptr: disabled)
+  int  checkpointInterval = 0;
+
 private:
   std::ofstream log;
 ///
@@ -0,0 +1,249 @@
+/**
+ * @file TourConstruction.cpp
+ * @brief construction heuristics for initial tours (nearest neighbour, greedy edge, space-filling
+ *        curve, Christofides-style MST tour) on a spatial index over the hole coordinates
+ *
+ */
+
+#include "TourConstruction.h"
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+/** union-find with path halving */
+static int findRoot ( std::vector<int>& parent , int u )
+{
+  while ( parent[u] != u ) {
+    parent[u] = parent[parent[u]];
+    u = parent[u];
+  }
+  return u;
+}
+
+double TourConstruction::length ( int i , int j ) const
+{
+  return metricDistance(tsp.metric, tsp.holes[i].first - tsp.holes[j].first, tsp.holes[i].second - tsp.holes[j].second);
+}
+
+std::vector<TourConstruction::Edge> TourConstruction::candidateEdges ( const std::vector<int>& ids ) const
+{
+  SpatialIndex index(tsp.holes, ids);
+  std::vector<std::pair<int, int>> pairs;
+  std::vector<int> near;
+  auto collect = [&]( int i ) {
+    index.kNearest(i, neighbours, near);
+    for ( int j : near ) pairs.push_back(std::make_pair(std::min(i, j), std::max(i, j)));
+  };
+  if ( ids.empty() ) for ( int i = 0 ; i < tsp.n ; ++i ) collect(i);
+  else for ( int i : ids ) collect(i);
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());   // (i, j) found from both ends
+  std::vector<Edge> edges(pairs.size());
+  for ( size_t e = 0 ; e < pairs.size() ; ++e ) edges[e] = Edge{length(pairs[e].first, pairs[e].second), pairs[e].first, pairs[e].second};
+  return edges;
+}
+
+std::vector<int> TourConstruction::nearestNeighbour ( ) const
+{
+  std::vector<int> order;
+  order.reserve(tsp.n);
+  SpatialIndex unvisited(tsp.holes);
+  int current = 0;
+  while ( current >= 0 ) {
+    order.push_back(current);
+    unvisited.remove(current);
+    current = unvisited.nearest(current);
+  }
+  return order;
+}
+
+std::vector<int> TourConstruction::greedyEdge ( ) const
+{
+  const int n = tsp.n;
+  std::vector<int> order;
+  if ( n < 3 ) {
+    for ( int i = 0 ; i < n ; ++i ) order.push_back(i);
+    return order;
+  }
+
+  // shortest candidate edges first (min-heap: only the edges actually examined are ordered)
+  std::vector<Edge> heap = candidateEdges(std::vector<int>());
+  std::make_heap(heap.begin(), heap.end(), std::greater<Edge>());
+  std::vector<int> parent(n), degree(n, 0), adj(2 * n, -1);
+  for ( int i = 0 ; i < n ; ++i ) parent[i] = i;
+  int taken = 0;
+  while ( !heap.empty() && taken < n - 1 ) {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<Edge>());
+    Edge e = heap.back();
+    heap.pop_back();
+    if ( degree[e.u] == 2 || degree[e.v] == 2 ) continue;
+    int ru = findRoot(parent, e.u), rv = findRoot(parent, e.v);
+    if ( ru == rv ) continue;                       // would close a subtour
+    parent[ru] = rv;
+    adj[2 * e.u + degree[e.u]++] = e.v;
+    adj[2 * e.v + degree[e.v]++] = e.u;
+    ++taken;
+  }
+
+  // join the fragments (paths; isolated holes are fragments of one hole): walk a fragment to its
+  // other end, then continue with the nearest endpoint of another fragment
+  std::vector<int> endpoints;
+  for ( int i = 0 ; i < n ; ++i ) if ( degree[i] < 2 ) endpoints.push_back(i);
+  SpatialIndex ends(tsp.holes, endpoints);
+  order.reserve(n);
+  int entry = endpoints[0];
+  while ( entry >= 0 ) {
+    ends.remove(entry);
+    int prev = -1, current = entry;
+    while ( current >= 0 ) {
+      order.push_back(current);
+      int next = -1;
+      for ( int s = 0 ; s < degree[current] ; ++s ) if ( adj[2 * current + s] != prev ) next = adj[2 * current + s];
+      prev = current;
+      current = next;
+    }
+    ends.remove(prev);                              // the fragment's other end
+    entry = ends.nearest(prev);
+  }
+  return order;
+}
+
+std::vector<int> TourConstruction::spaceFillingCurve ( ) const
+{
+  uint32_t side = hilbertSide(tsp.holes);
+  std::vector<std::pair<uint64_t, int>> keys(tsp.n);
+  for ( int i = 0 ; i < tsp.n ; ++i ) keys[i] = std::make_pair(hilbertIndex(side, tsp.holes[i].first, tsp.holes[i].second), i);
+  std::sort(keys.begin(), keys.end());
+  std::vector<int> order(tsp.n);
+  for ( int i = 0 ; i < tsp.n ; ++i ) order[i] = keys[i].second;
+  return order;
+}
+
+std::vector<int> TourConstruction::christofides ( ) const
+{
+  const int n = tsp.n;
+  std::vector<int> order;
+  if ( n < 3 ) {
+    for ( int i = 0 ; i < n ; ++i ) order.push_back(i);
+    return order;
+  }
+
+  // 1. minimum spanning tree of the candidate graph (Kruskal)
+  std::vector<std::pair<int, int>> edges;           // multigraph: tree + matching
+  std::vector<int> parent(n), degree(n, 0);
+  for ( int i = 0 ; i < n ; ++i ) parent[i] = i;
+  std::vector<Edge> heap = candidateEdges(std::vector<int>());
+  std::make_heap(heap.begin(), heap.end(), std::greater<Edge>());
+  while ( !heap.empty() && (int)edges.size() < n - 1 ) {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<Edge>());
+    Edge e = heap.back();
+    heap.pop_back();
+    int ru = findRoot(parent, e.u), rv = findRoot(parent, e.v);
+    if ( ru == rv ) continue;
+    parent[ru] = rv;
+    edges.push_back(std::make_pair(e.u, e.v));
+  }
+  if ( (int)edges.size() < n - 1 ) {
+    // candidate graph not connected (distant clusters): chain the components along the Hilbert curve
+    std::vector<int> curve = spaceFillingCurve();
+    for ( int k = 1 ; k < n ; ++k ) {
+      int ru = findRoot(parent, curve[k - 1]), rv = findRoot(parent, curve[k]);
+      if ( ru == rv ) continue;
+      parent[ru] = rv;
+      edges.push_back(std::make_pair(curve[k - 1], curve[k]));
+    }
+  }
+  for ( const auto& e : edges ) { ++degree[e.first]; ++degree[e.second]; }
+
+  // 2. greedy matching of the odd-degree nodes: shortest candidate edges first, the rest nearest first
+  std::vector<int> odd;
+  for ( int i = 0 ; i < n ; ++i ) if ( degree[i] % 2 ) odd.push_back(i);
+  std::vector<char> matched(n, 0);
+  heap = candidateEdges(odd);
+  std::make_heap(heap.begin(), heap.end(), std::greater<Edge>());
+  while ( !heap.empty() ) {
+    std::pop_heap(heap.begin(), heap.end(), std::greater<Edge>());
+    Edge e = heap.back();
+    heap.pop_back();
+    if ( matched[e.u] || matched[e.v] ) continue;
+    matched[e.u] = matched[e.v] = 1;
+    edges.push_back(std::make_pair(e.u, e.v));
+  }
+  std::vector<int> unmatched;
+  for ( int i : odd ) if ( !matched[i] ) unmatched.push_back(i);
+  if ( !unmatched.empty() ) {
+    SpatialIndex rest(tsp.holes, unmatched);
+    for ( int u : unmatched ) {
+      if ( !rest.contains(u) ) continue;
+      rest.remove(u);
+      int v = rest.nearest(u);
+      if ( v < 0 ) break;
+      rest.remove(v);
+      edges.push_back(std::make_pair(u, v));
+    }
+  }
+
+  // 3. Euler tour (Hierholzer) from hole 0, shortcut to the first visit of every hole
+  std::vector<std::vector<int>> incident(n);
+  for ( size_t e = 0 ; e < edges.size() ; ++e ) {
+    incident[edges[e].first].push_back(e);
+    incident[edges[e].second].push_back(e);
+  }
+  std::vector<char> used(edges.size(), 0), visited(n, 0);
+  std::vector<size_t> next(n, 0);
+  std::vector<int> stack(1, 0);
+  order.reserve(n);
+  while ( !stack.empty() ) {
+    int v = stack.back();
+    while ( next[v] < incident[v].size() && used[incident[v][next[v]]] ) ++next[v];
+    if ( next[v] == incident[v].size() ) {
+      if ( !visited[v] ) { visited[v] = 1; order.push_back(v); }
+      stack.pop_back();
+      continue;
+    }
+    int e = incident[v][next[v]];
+    used[e] = 1;
+    stack.push_back(edges[e].first == v ? edges[e].second : edges[e].first);
+  }
+  return order;
+}
+
+bool TourConstruction::build ( ConstructionMethod method , TSPSolution& sol ) const
+{
+  if ( method == CONSTRUCT_RANDOM || tsp.n < 1 || (int)tsp.holes.size() != tsp.n ) return false;
+  std::vector<int> order;
+  switch ( method ) {
+    case CONSTRUCT_NEAREST_NEIGHBOUR:   order = nearestNeighbour(); break;
+    case CONSTRUCT_GREEDY_EDGE:         order = greedyEdge(); break;
+    case CONSTRUCT_SPACE_FILLING_CURVE: order = spaceFillingCurve(); break;
+    case CONSTRUCT_CHRISTOFIDES:        order = christofides(); break;
+    default: return false;
+  }
+  std::rotate(order.begin(), std::find(order.begin(), order.end(), 0), order.end());
+  sol.sequence = order;
+  sol.sequence.push_back(0);
+  return true;
+}
+
+bool TourConstruction::parseMethod ( const std::string& name , ConstructionMethod& method )
+{
+  static const ConstructionMethod methods[] = { CONSTRUCT_RANDOM, CONSTRUCT_NEAREST_NEIGHBOUR, CONSTRUCT_GREEDY_EDGE,
+                                                CONSTRUCT_SPACE_FILLING_CURVE, CONSTRUCT_CHRISTOFIDES };
+  for ( ConstructionMethod m : methods ) {
+    if ( name == methodName(m) ) { method = m; return true; }
+  }
+  return false;
+}
+
+const char* TourConstruction::methodName ( ConstructionMethod method )
+{
+  switch ( method ) {
+    case CONSTRUCT_NEAREST_NEIGHBOUR:   return "nn";
+    case CONSTRUCT_GREEDY_EDGE:         return "greedy";
+    case CONSTRUCT_SPACE_FILLING_CURVE: return "sfc";
+    case CONSTRUCT_CHRISTOFIDES:        return "christofides";
+    default:                            return "random";
+  }
+}
@@ -0,0 +1,80 @@
+/**
+ * @file TourConstruction.h
+ * @brief construction heuristics for initial tours (nearest neighbour, greedy edge, space-filling
+ *        curve, Christofides-style MST tour) on a spatial index over the hole coordinates
+ *
+ */
+
+#ifndef TOURCONSTRUCTION_H
+#define TOURCONSTRUCTION_H
+
+#include <vector>
+#include <string>
+
+#include "TSP.h"
+#include "TSPSolution.h"
+
+/**
+ * Initial tour construction
+ */
+enum ConstructionMethod {
+  CONSTRUCT_RANDOM,              // random swaps (TSPSolver::initRnd)
+  CONSTRUCT_NEAREST_NEIGHBOUR,
+  CONSTRUCT_GREEDY_EDGE,
+  CONSTRUCT_SPACE_FILLING_CURVE,
+  CONSTRUCT_CHRISTOFIDES
+};
+
+/**
+ * Class that builds tours from the hole coordinates of a TSP instance (distances in the instance's
+ * metric, candidate neighbours by Euclidean proximity; the cost matrix is never read, so the
+ * heuristics also serve boards too large for one).
+ * Every method runs in O(n log n) on evenly spread boards thanks to a bucket grid (SpatialIndex):
+ * - nearest neighbour: from hole 0, repeatedly the closest hole not yet visited
+ * - greedy edge: the shortest edges of the k-nearest-neighbour candidate graph are taken in order
+ *   (Kruskal-style, no node of degree 3, no subtour); the fragments are then joined nearest
+ *   endpoint first
+ * - space-filling curve: holes in the order of their position along a Hilbert curve
+ * - Christofides: minimum spanning tree of the candidate graph, plus a matching of its odd-degree
+ *   nodes, Euler tour, shortcut to a tour. The matching is greedy (shortest candidate edges first)
+ *   instead of the O(n^3) minimum-weight perfect matching, so the 3/2 guarantee does not hold
+ */
+class TourConstruction
+{
+public:
+  TourConstruction ( const TSP& tsp , int neighbours = 10 ) : tsp(tsp) , neighbours(neighbours) { }
+
+  /** build a tour
+  * @param method construction heuristic
+  * @param sol output: tour in the TSPSolution layout <0, ..., 0>
+  * @return false (sol untouched) for CONSTRUCT_RANDOM or an instance without coordinates
+  */
+  bool build ( ConstructionMethod method , TSPSolution& sol ) const;
+
+  std::vector<int> nearestNeighbour ( ) const;
+  std::vector<int> greedyEdge ( ) const;
+  std::vector<int> spaceFillingCurve ( ) const;
+  std::vector<int> christofides ( ) const;
+
+  /** method from its command line name (random, nn, greedy, sfc, christofides)
+  * @return false if the name is unknown
+  */
+  static bool parseMethod ( const std::string& name , ConstructionMethod& method );
+  static const char* methodName ( ConstructionMethod method );
+
+protected:
+  struct Edge {
+    double length;
+    int    u, v;
+    bool operator> ( const Edge& other ) const { return length > other.length; }
+  };
+
+  double length ( int i , int j ) const;
+  /** edges of the k-nearest-neighbour graph among 'ids' (all holes if empty), each once */
+  std::vector<Edge> candidateEdges ( const std::vector<int>& ids ) const;
+
+  const TSP& tsp;
+  int        neighbours;   // k of the candidate graph
+};
+
+#endif /* TOURCONSTRUCTION_H */
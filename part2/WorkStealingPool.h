@@ -0,0 +1,132 @@
+/**
+ * @file WorkStealingPool.h
+ * @brief fixed-size thread pool with per-worker task queues and work stealing
+ *
+ */
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <atomic>
+
+/**
+ * Thread pool where every worker owns a task deque: it pops its own tasks from the back (LIFO, cache
+ * friendly) and, when empty, steals from the front of the other workers' deques.
+ * Tasks submitted from outside the pool are distributed round-robin.
+ */
+class WorkStealingPool
+{
+public:
+  typedef std::function<void()> Task;
+
+  explicit WorkStealingPool ( int numThreads = std::thread::hardware_concurrency() ) {
+    if ( numThreads < 1 ) numThreads = 1;
+    for ( int i = 0 ; i < numThreads ; ++i ) queues.emplace_back(new Queue());
+    for ( int i = 0 ; i < numThreads ; ++i ) threads.emplace_back(&WorkStealingPool::run, this, i);
+  }
+
+  ~WorkStealingPool ( ) {
+    wait();
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stopping = true;
+    }
+    available.notify_all();
+    for ( std::thread& t : threads ) t.join();
+  }
+
+  int size ( ) const { return (int)threads.size(); }
+
+  /** enqueue a task (on the caller's own deque if called from a worker) */
+  void submit ( Task task ) {
+    int q = ( currentPool() == this ) ? currentWorker() : (int)( nextQueue++ % queues.size() );
+    {
+      std::lock_guard<std::mutex> lock(queues[q]->mtx);
+      queues[q]->tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      ++queued;
+      ++pending;
+    }
+    available.notify_one();
+  }
+
+  /** block until every submitted task has completed */
+  void wait ( ) {
+    std::unique_lock<std::mutex> lock(mtx);
+    done.wait(lock, [this] { return pending == 0; });
+  }
+
+protected:
+  struct Queue {
+    std::mutex       mtx;
+    std::deque<Task> tasks;
+  };
+
+  static WorkStealingPool*& currentPool ( ) { static thread_local WorkStealingPool* pool = nullptr; return pool; }
+  static int& currentWorker ( ) { static thread_local int id = -1; return id; }
+
+  bool pop ( int id , Task& task ) {
+    {
+      Queue& own = *queues[id];
+      std::lock_guard<std::mutex> lock(own.mtx);
+      if ( !own.tasks.empty() ) {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        return true;
+      }
+    }
+    for ( size_t k = 1 ; k < queues.size() ; ++k ) {
+      Queue& victim = *queues[( id + k ) % queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mtx);
+      if ( !victim.tasks.empty() ) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void run ( int id ) {
+    currentPool() = this;
+    currentWorker() = id;
+    while ( true ) {
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        available.wait(lock, [this] { return stopping || queued > 0; });
+        if ( queued == 0 ) return;            // stopping and nothing left
+        --queued;                             // reserve one task: some deque holds it for us
+      }
+      Task task;
+      while ( !pop(id, task) ) std::this_thread::yield();
+      task();
+      bool finished;
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        finished = ( --pending == 0 );
+      }
+      if ( finished ) done.notify_all();
+    }
+  }
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread>            threads;
+  std::mutex                          mtx;
+  std::condition_variable             available;
+  std::condition_variable             done;
+  long                                queued = 0;    // tasks sitting in some deque
+  long                                pending = 0;   // tasks submitted and not completed
+  bool                                stopping = false;
+  std::atomic<unsigned long>          nextQueue { 0 };
+};
+
+#endif /* WORKSTEALINGPOOL_H */
@@ -9,6 +9,11 @@
 #include <sys/time.h>
 
 #include "TSPSolver.h"
+#include "LowerBound.h"
+#include "MemeticSolver.h"
+#include "DecompositionSolver.h"
+#include "TourConstruction.h"
+#include "IncrementalSolver.h"
 
 // error status and messagge buffer
 int status;
@@ -21,7 +26,7 @@ int main (int argc, char const *argv[])
 {
   try
   {
-    if (argc < 2) throw std::runtime_error("usage: ./main filename.dat [--alpha=0.7 --beta=0.5 --decayFactor=0.9 --lambda=0.01 --logFile=log.txt]");
+    if (argc < 2) throw std::runtime_error("usage: ./main filename.dat [--alpha=0.7 --beta=0.5 --decayFactor=0.9 --lambda=0.01 --logFile=log.txt --tourFile=board.tour --symmetric --metric=euclidean|manhattan|chebyshev|rounded --gridDistances --hilbert --cacheDir=dir --lowerBound --targetGap=0.01 --maxIterations=1000 --seed=1 --checkpoint=run.ckpt --checkpointEvery=1000 --resume=run.ckpt --stats --trace=trace.json --memetic --initRuns=4 --generations=50 --offspring=8 --polishIterations=200 --threads=4 --timeLimit=60 --init=random|nn|greedy|sfc|christofides --decompose --clusterSize=200 --windowSize=100 --passes=4 --incremental=prev.tour --previousBoard=prev.dat]");
 
     // Default parameters
     double alpha = 0.75;
@@ -29,6 +34,27 @@ int main (int argc, char const *argv[])
     double decayFactor = 0.9;
     double lambda = 0.01;
     std::string logFileName = ""; // Default empty, will be set from argument or derived
+    std::string tourFileName = ""; // compact tour file (only written if requested)
+    bool computeBound = false;
+    bool symmetric = false;       // packed triangular storage of distances and frequencies
+    bool gridDistances = false;   // no cost matrix: distances looked up by coordinate differences (--symmetric: packed frequencies)
+    DistanceMetric metric = METRIC_EUCLIDEAN;  // travel time model of the drill head
+    bool hilbert = false;         // nodes renumbered along a Hilbert curve (tours reported in file ids)
+    std::string cacheDir = "";    // on-disk instance cache (empty: disabled)
+    double targetGap = -1.0;      // stop when within this relative gap from the lower bound (< 0: disabled)
+    std::string checkpointFile = "";  // periodic search state snapshots (empty: disabled)
+    int checkpointEvery = 1000;       // iterations between snapshots
+    std::string resumeFile = "";      // continue the search saved in this checkpoint
+    unsigned int seed = 0;            // random generator seed (0: from the clock)
+    bool printStats = false;          // search counters and phase timers (summary table)
+    std::string traceFile = "";       // ... and Chrome trace-event JSON
+    bool memetic = false;             // memetic search (GPX over elite tours) instead of a single tabu run
+    MemeticParams memeticParams;      // (its initial tabu runs use maxIterations)
+    ConstructionMethod initMethod = CONSTRUCT_RANDOM;  // initial tour
+    bool decompose = false;           // spatial decomposition (very large boards: no n x n matrix)
+    DecompositionParams decompositionParams;  // (cluster tours use maxIterations)
+    std::string previousTourName = "";    // incremental re-optimization: tour of the previous board ...
+    std::string previousBoardName = "";   // ... and the previous board itself
 
     // parsing
     for (int i = 2; i < argc; ++i) {
@@ -43,14 +69,209 @@ int main (int argc, char const *argv[])
         lambda = std::stod(arg.substr(9));
       } else if (arg.find("--logFile=") == 0) {
         logFileName = arg.substr(10);
+      } else if (arg.find("--tourFile=") == 0) {
+        tourFileName = arg.substr(11);
+      } else if (arg == "--symmetric") {
+        symmetric = true;
+      } else if (arg == "--gridDistances") {
+        gridDistances = true;
+      } else if (arg.find("--metric=") == 0) {
+        if (!parseMetric(arg.substr(9), metric)) throw std::runtime_error("unknown metric: " + arg.substr(9));
+      } else if (arg == "--hilbert") {
+        hilbert = true;
+      } else if (arg.find("--cacheDir=") == 0) {
+        cacheDir = arg.substr(11);
+      } else if (arg == "--lowerBound") {
+        computeBound = true;
+      } else if (arg.find("--targetGap=") == 0) {
+        targetGap = std::stod(arg.substr(12));
+        computeBound = true;
+      } else if (arg.find("--maxIterations=") == 0) {
+        maxIterations = std::stoi(arg.substr(16));
+      } else if (arg.find("--seed=") == 0) {
+        seed = std::stoul(arg.substr(7));
+      } else if (arg.find("--checkpoint=") == 0) {
+        checkpointFile = arg.substr(13);
+      } else if (arg.find("--checkpointEvery=") == 0) {
+        checkpointEvery = std::stoi(arg.substr(18));
+      } else if (arg.find("--resume=") == 0) {
+        resumeFile = arg.substr(9);
+      } else if (arg == "--stats") {
+        printStats = true;
+      } else if (arg.find("--trace=") == 0) {
+        traceFile = arg.substr(8);
+      } else if (arg == "--memetic") {
+        memetic = true;
+      } else if (arg.find("--generations=") == 0) {
+        memeticParams.generations = std::stoi(arg.substr(14));
+      } else if (arg.find("--initRuns=") == 0) {
+        memeticParams.initRuns = std::stoi(arg.substr(11));
+      } else if (arg.find("--offspring=") == 0) {
+        memeticParams.offspring = std::stoi(arg.substr(12));
+      } else if (arg.find("--polishIterations=") == 0) {
+        memeticParams.polishIterations = std::stoi(arg.substr(19));
+      } else if (arg.find("--threads=") == 0) {
+        memeticParams.threads = std::stoi(arg.substr(10));
+        decompositionParams.threads = memeticParams.threads;
+      } else if (arg.find("--timeLimit=") == 0) {
+        memeticParams.timeLimit = std::stod(arg.substr(12));
+      } else if (arg.find("--init=") == 0) {
+        if (!TourConstruction::parseMethod(arg.substr(7), initMethod)) throw std::runtime_error("unknown initial tour: " + arg.substr(7));
+      } else if (arg == "--decompose") {
+        decompose = true;
+      } else if (arg.find("--clusterSize=") == 0) {
+        decompositionParams.clusterSize = std::stoi(arg.substr(14));
+      } else if (arg.find("--windowSize=") == 0) {
+        decompositionParams.windowSize = std::stoi(arg.substr(13));
+      } else if (arg.find("--passes=") == 0) {
+        decompositionParams.passes = std::stoi(arg.substr(9));
+      } else if (arg.find("--incremental=") == 0) {
+        previousTourName = arg.substr(14);
+      } else if (arg.find("--previousBoard=") == 0) {
+        previousBoardName = arg.substr(16);
       } else {
         std::cerr << "Warning: Unknown parameter: " << arg << std::endl;
       }
     }
     
+    if (memetic && (!checkpointFile.empty() || !resumeFile.empty() || printStats || !traceFile.empty())) {
+      throw std::runtime_error("--memetic does not support --checkpoint, --resume, --stats or --trace");
+    }
+
     /// create the instance (reading data)
     TSP tspInstance;
-    tspInstance.read(argv[1]);
+    tspInstance.metric = metric;
+
+    /// incremental: the previous tour is repaired around the edits (coordinates only, file order)
+    if (!previousTourName.empty()) {
+      if (previousBoardName.empty()) throw std::runtime_error("--incremental needs --previousBoard");
+      TSP previousInstance;
+      if (!previousInstance.load(previousBoardName.c_str())) throw std::runtime_error("cannot read board " + previousBoardName);
+      if (!tspInstance.load(argv[1])) throw std::runtime_error("cannot read board " + std::string(argv[1]));
+      std::cout << "Extracted " << tspInstance.n << " holes from grid.\n";
+      TSPSolution previousTour;
+      if (!previousTour.read(previousTourName)) throw std::runtime_error("cannot read tour " + previousTourName);
+      IncrementalParams incrementalParams;
+      incrementalParams.windowSize = decompositionParams.windowSize;
+      incrementalParams.seed = seed != 0 ? seed : (unsigned int)time(NULL);
+      incrementalParams.alpha = alpha;
+      incrementalParams.beta = beta;
+      incrementalParams.decayFactor = decayFactor;
+      incrementalParams.lambda = lambda;
+      incrementalParams.metric = metric;
+      struct timeval tv1, tv2;
+      gettimeofday(&tv1, NULL);
+      IncrementalSolver incrementalSolver(incrementalParams);
+      std::vector<int> tour;
+      double value = incrementalSolver.solve(previousInstance.holes, previousTour.sequence, tspInstance.holes, tour);
+      gettimeofday(&tv2, NULL);
+      std::cout << "INCREMENTAL: " << incrementalSolver.getKept() << " holes kept, " << incrementalSolver.getRemoved()
+                << " removed, " << incrementalSolver.getInserted() << " inserted, repaired tour "
+                << incrementalSolver.getRepairedValue() << ", " << incrementalSolver.getTwoOptMoves() << " 2-opt moves, "
+                << incrementalSolver.getWindowsImproved() << " windows improved\n";
+      std::cout << "in " << (double)(tv2.tv_sec+tv2.tv_usec*1e-6 - (tv1.tv_sec+tv1.tv_usec*1e-6)) << " seconds (user time)\n";
+      if (!tourFileName.empty()) {
+        TSPSolution solution;
+        solution.sequence = tour;
+        solution.sequence.push_back(tour.empty() ? 0 : tour[0]);
+        if (!solution.write(tourFileName, value)) std::cerr << "Error writing tour file: " << tourFileName << std::endl;
+      }
+      std::cout << "FINAL_VALUE: " << value << std::endl;
+      return 0;
+    }
+
+    /// decomposition: only the coordinates are loaded (subproblems build their own small matrices)
+    if (decompose) {
+      if (!tspInstance.load(argv[1])) throw std::runtime_error("cannot read board " + std::string(argv[1]));
+      std::cout << "Extracted " << tspInstance.n << " holes from grid.\n";
+      if (hilbert) tspInstance.renumberHilbert();
+      decompositionParams.clusterIterations = maxIterations;
+      decompositionParams.seed = seed != 0 ? seed : (unsigned int)time(NULL);
+      decompositionParams.alpha = alpha;
+      decompositionParams.beta = beta;
+      decompositionParams.decayFactor = decayFactor;
+      decompositionParams.lambda = lambda;
+      decompositionParams.metric = metric;
+      struct timeval tv1, tv2;
+      gettimeofday(&tv1, NULL);
+      DecompositionSolver decompositionSolver(decompositionParams);
+      std::vector<int> tour;
+      double value = decompositionSolver.solve(tspInstance.holes, tour);
+      gettimeofday(&tv2, NULL);
+      std::cout << "DECOMPOSITION: " << decompositionSolver.getClusters() << " clusters, stitched tour "
+                << decompositionSolver.getStitchedValue() << ", " << decompositionSolver.getWindowsImproved()
+                << " windows improved\n";
+      std::cout << "in " << (double)(tv2.tv_sec+tv2.tv_usec*1e-6 - (tv1.tv_sec+tv1.tv_usec*1e-6)) << " seconds (user time)\n";
+      if (!tourFileName.empty()) {
+        TSPSolution solution;
+        solution.sequence = tour;
+        solution.sequence.push_back(tour.empty() ? 0 : tour[0]);
+        solution.sequence = tspInstance.originalTour(solution.sequence);
+        if (!solution.write(tourFileName, value)) std::cerr << "Error writing tour file: " << tourFileName << std::endl;
+      }
+      std::cout << "FINAL_VALUE: " << value << std::endl;
+      return 0;
+    }
+
+    if (gridDistances) {
+      if (!tspInstance.load(argv[1])) throw std::runtime_error("cannot read board " + std::string(argv[1]));
+      std::cout << "Extracted " << tspInstance.n << " holes from grid.\n";
+      if (hilbert) tspInstance.renumberHilbert();
+      if (!tspInstance.useGridDistances(symmetric)) {
+        std::cerr << "Warning: board side above " << GridDistanceTable::MAX_SIDE << ", using the cost matrix" << std::endl;
+        tspInstance.computeCostMatrix(symmetric);
+      }
+    } else if (cacheDir.empty()) {
+      tspInstance.read(argv[1], symmetric, hilbert);
+    } else {
+      InstanceCacheOptions cacheOptions;
+      cacheOptions.dir = cacheDir;
+      tspInstance.loadCached(argv[1], cacheOptions, symmetric, hilbert);
+    }
+
+    /// lower bound (Held-Karp) for gap reporting and early termination
+    double lowerBound = 0.0;
+    if (computeBound) {
+      lowerBound = TSPLowerBound(tspInstance).heldKarp();
+    }
+    // value <= bound / (1 - gap)  <=>  (value - bound) / value <= gap
+    double targetValue = targetGap >= 0 ? lowerBound / (1.0 - std::min(targetGap, 0.99)) : -1.0;
+
+    /// memetic search: independent tabu runs and crossover (no log, no single starting tour)
+    if (memetic) {
+      memeticParams.initIterations = maxIterations;
+      memeticParams.seed = seed != 0 ? seed : (unsigned int)time(NULL);
+      memeticParams.alpha = alpha;
+      memeticParams.beta = beta;
+      memeticParams.decayFactor = decayFactor;
+      memeticParams.lambda = lambda;
+      memeticParams.targetValue = targetValue;
+      memeticParams.init = initMethod;
+      struct timeval tv1, tv2;
+      gettimeofday(&tv1, NULL);
+      MemeticSolver memeticSolver(memeticParams);
+      TSPSolution bestSolution(tspInstance);
+      double value = memeticSolver.solve(tspInstance, bestSolution);
+      gettimeofday(&tv2, NULL);
+      std::cout << "MEMETIC: " << memeticSolver.getGenerations() << " generations, "
+                << memeticSolver.getPartitions() << " partitions, "
+                << memeticSolver.getChildrenAccepted() << " tours accepted\n";
+      TSPSolution finalTour(bestSolution);
+      finalTour.sequence = tspInstance.originalTour(bestSolution.sequence);
+      std::cout << "TO   solution: ";
+      finalTour.print();
+      std::cout << "(value : " << value << ")\n";
+      std::cout << "in " << (double)(tv2.tv_sec+tv2.tv_usec*1e-6 - (tv1.tv_sec+tv1.tv_usec*1e-6)) << " seconds (user time)\n";
+      if (computeBound) {
+        std::cout << "LOWER_BOUND: " << lowerBound << "\n";
+        std::cout << "GAP: " << TSPLowerBound::gap(value, lowerBound) << "\n";
+      }
+      if (!tourFileName.empty() && !finalTour.write(tourFileName, value)) {
+        std::cerr << "Error writing tour file: " << tourFileName << std::endl;
+      }
+      std::cout << "FINAL_VALUE: " << value << std::endl;
+      return 0;
+    }
 
     // If --logFile was not provided, derive it from the input filename
     if (logFileName.empty()) {
@@ -64,7 +285,7 @@ int main (int argc, char const *argv[])
     }
 
     TSPSolution aSolution(tspInstance);
-    
+
     /// initialize clocks for running time recording
     ///   two ways:
     ///   1) CPU time (t2 - t1)
@@ -76,8 +297,26 @@ int main (int argc, char const *argv[])
     
     /// create solver class
     TSPSolver tspSolver(logFileName, alpha, beta, decayFactor, lambda);
-    /// initial solution (random)
-    tspSolver.initRnd(aSolution);
+    if (targetGap >= 0) tspSolver.setTargetValue(targetValue);
+    if (seed != 0) tspSolver.setSeed(seed);
+    /// initial solution (construction heuristic, random if none)
+    if (!TourConstruction(tspInstance).build(initMethod, aSolution)) tspSolver.initRnd(aSolution);
+
+    /// checkpointing: a resumed run keeps writing to its own checkpoint unless told otherwise
+    if (!resumeFile.empty()) {
+      if (!tspSolver.loadCheckpoint(resumeFile, tspInstance)) throw std::runtime_error("cannot resume from " + resumeFile);
+      std::cout << "Resuming from " << resumeFile << " at iteration " << tspSolver.getIteration()
+                << " (value " << tspSolver.getIncumbentValue() << "; tabu parameters of the checkpointed run)\n";
+      if (checkpointFile.empty()) checkpointFile = resumeFile;
+    }
+    tspSolver.setCheckpoint(checkpointFile, checkpointEvery);
+
+    /// instrumentation (only if requested: otherwise the solver does not read any clock)
+    std::unique_ptr<Instrumentation> instrumentation;
+    if (printStats || !traceFile.empty()) {
+      instrumentation.reset(new Instrumentation());
+      tspSolver.setInstrumentation(instrumentation.get());
+    }
     
     /// run the neighbourhood search
     TSPSolution bestSolution(tspInstance);
@@ -87,14 +326,32 @@ int main (int argc, char const *argv[])
     t2 = clock();
     gettimeofday(&tv2, NULL);
     
+    /// tours are reported in board file hole ids
+    TSPSolution initialTour(aSolution), finalTour(bestSolution);
+    initialTour.sequence = tspInstance.originalTour(aSolution.sequence);
+    finalTour.sequence = tspInstance.originalTour(bestSolution.sequence);
+
     std::cout << "FROM solution: "; 
-    aSolution.print();
+    initialTour.print();
     std::cout << "(value : " << tspSolver.evaluate(aSolution,tspInstance) << ")\n";
     std::cout << "TO   solution: "; 
-    bestSolution.print();
+    finalTour.print();
     std::cout << "(value : " << tspSolver.evaluate(bestSolution,tspInstance) << ")\n";
     std::cout << "in " << (double)(tv2.tv_sec+tv2.tv_usec*1e-6 - (tv1.tv_sec+tv1.tv_usec*1e-6)) << " seconds (user time)\n";
     std::cout << "in " << (double)(t2-t1) / CLOCKS_PER_SEC << " seconds (CPU time)\n";
+    if (computeBound) {
+      std::cout << "LOWER_BOUND: " << lowerBound << "\n";
+      std::cout << "GAP: " << TSPLowerBound::gap(tspSolver.evaluate(bestSolution, tspInstance), lowerBound) << "\n";
+    }
+    if (!tourFileName.empty() && !finalTour.write(tourFileName, tspSolver.evaluate(bestSolution, tspInstance))) {
+      std::cerr << "Error writing tour file: " << tourFileName << std::endl;
+    }
+    if (instrumentation) {
+      instrumentation->printSummary(std::cout);
+      if (!traceFile.empty() && !instrumentation->writeTrace(traceFile)) {
+        std::cerr << "Error writing trace file: " << traceFile << std::endl;
+      }
+    }
     std::cout << "FINAL_VALUE: " << tspSolver.evaluate(bestSolution, tspInstance) << std::endl;
   }
   catch(std::exception& e)
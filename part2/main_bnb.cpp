@@ -0,0 +1,104 @@
+/**
+ * @file main_bnb.cpp
+ * @brief exact solver: tabu search tour as upper bound, then 1-tree branch-and-bound
+ */
+
+
+#include <stdexcept>
+#include <ctime>
+#include <sys/time.h>
+#include <thread>
+
+#include "TSPSolver.h"
+#include "BranchAndBound.h"
+
+int tabuLength = 10;
+int maxIterations = 1000;
+
+
+int main (int argc, char const *argv[])
+{
+  try
+  {
+    if (argc < 2) throw std::runtime_error("usage: ./main_bnb filename.dat [--threads=4 --timeLimit=60 --nodeLimit=0 --logFile=log.txt --cacheDir=dir]");
+
+    // Default parameters
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    double timeLimit = 0.0;
+    long nodeLimit = 0;
+    std::string logFileName = "";
+    std::string cacheDir = "";   // on-disk instance cache (empty: disabled)
+
+    // parsing
+    for (int i = 2; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (arg.find("--threads=") == 0) {
+        threads = std::stoi(arg.substr(10));
+      } else if (arg.find("--timeLimit=") == 0) {
+        timeLimit = std::stod(arg.substr(12));
+      } else if (arg.find("--nodeLimit=") == 0) {
+        nodeLimit = std::stol(arg.substr(12));
+      } else if (arg.find("--logFile=") == 0) {
+        logFileName = arg.substr(10);
+      } else if (arg.find("--cacheDir=") == 0) {
+        cacheDir = arg.substr(11);
+      } else {
+        std::cerr << "Warning: Unknown parameter: " << arg << std::endl;
+      }
+    }
+
+    /// create the instance (reading data)
+    TSP tspInstance;
+    // the 1-tree relaxation needs symmetric distances anyway
+    if (cacheDir.empty()) {
+      tspInstance.read(argv[1], true);
+    } else {
+      InstanceCacheOptions cacheOptions;
+      cacheOptions.dir = cacheDir;
+      tspInstance.loadCached(argv[1], cacheOptions, true);
+    }
+
+    if (logFileName.empty()) {
+      std::string inputFile = argv[1];
+      size_t dotPos = inputFile.find_last_of('.');
+      logFileName = (dotPos != std::string::npos ? inputFile.substr(0, dotPos) : inputFile) + "_bnb_log.txt";
+    }
+
+    struct timeval  tv1, tv2, tv3;
+    gettimeofday(&tv1, NULL);
+
+    /// upper bound: tabu search tour
+    TSPSolution aSolution(tspInstance);
+    TSPSolution heurSolution(tspInstance);
+    TSPSolver tspSolver(logFileName);
+    tspSolver.initRnd(aSolution);
+    tspSolver.solve(tspInstance, aSolution, tabuLength, maxIterations, heurSolution);
+    double heurValue = tspSolver.evaluate(heurSolution, tspInstance);
+    gettimeofday(&tv2, NULL);
+
+    /// branch-and-bound
+    TSPBranchAndBound bnb(threads, timeLimit, nodeLimit);
+    TSPSolution bestSolution(tspInstance);
+    bnb.solve(tspInstance, heurSolution, bestSolution);
+    gettimeofday(&tv3, NULL);
+
+    double bestValue = tspSolver.evaluate(bestSolution, tspInstance);
+    double gap = (bestValue > 0) ? (bestValue - bnb.getLowerBound()) / bestValue : 0.0;
+
+    std::cout << "TABU value: " << heurValue << " in " << (double)(tv2.tv_sec+tv2.tv_usec*1e-6 - (tv1.tv_sec+tv1.tv_usec*1e-6)) << " seconds\n";
+    std::cout << "ROOT_BOUND: " << bnb.getRootBound() << "\n";
+    std::cout << "NODES: " << bnb.getNodeCount() << " (" << threads << " threads)\n";
+    std::cout << "BEST solution: ";
+    bestSolution.print();
+    std::cout << "\nin " << (double)(tv3.tv_sec+tv3.tv_usec*1e-6 - (tv2.tv_sec+tv2.tv_usec*1e-6)) << " seconds (branch-and-bound)\n";
+    std::cout << "STATUS: " << (bnb.isOptimal() ? "OPTIMAL" : "LIMIT") << "\n";
+    std::cout << "LOWER_BOUND: " << bnb.getLowerBound() << "\n";
+    std::cout << "GAP: " << gap << "\n";
+    std::cout << "FINAL_VALUE: " << bestValue << std::endl;
+  }
+  catch(std::exception& e)
+  {
+    std::cout << ">>>EXCEPTION: " << e.what() << std::endl;
+  }
+  return 0;
+}
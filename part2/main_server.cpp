@@ -0,0 +1,205 @@
+/**
+ * @file main_server.cpp
+ * @brief solver server: tabu search jobs as JSON lines, on stdin/stdout or on a Unix domain socket
+ *
+ * One request per line:
+ *   {"id":"b1","board":"boards/board_50.dat","maxIterations":2000,"timeLimit":5,"alpha":0.7,"seed":1}
+ *   {"id":"b2","holes":[[0,0],[3,4],[7,1],[2,9]],"size":10,"symmetric":true}
+ *   {"cancel":"b1"}
+ * One result line per job, in completion order:
+ *   {"id":"b1","status":"done|timeout|cancelled|error","value":...,"iterations":...,"tour":[...],...}
+ */
+
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <csignal>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <climits>
+#include <algorithm>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "SolverServer.h"
+#include "JsonLine.h"
+
+/** build a job from a request line (throws std::runtime_error on invalid requests) */
+static std::shared_ptr<SolverJob> parseJob ( const JsonObject& request , const std::shared_ptr<JobOutput>& output )
+{
+  std::shared_ptr<SolverJob> job(new SolverJob());
+  job->output = output;
+  for ( const auto& field : request ) {
+    const std::string& key = field.first;
+    const JsonValue& v = field.second;
+    if ( key == "id" ) job->id = ( v.type == JsonValue::STRING ) ? v.str : std::to_string((long long)v.num);
+    else if ( key == "board" ) job->board = v.str;
+    else if ( key == "holes" ) {
+      if ( v.type != JsonValue::ARRAY || v.rows.size() * 2 != v.array.size() ||
+           std::count(v.rows.begin(), v.rows.end(), (size_t)2) != (long)v.rows.size() ) {
+        throw std::runtime_error("holes: expected [[x,y],...]");
+      }
+      for ( size_t i = 0 ; i < v.array.size() ; i += 2 ) {
+        for ( double c : { v.array[i], v.array[i + 1] } ) {
+          if ( c != std::floor(c) ) throw std::runtime_error("holes: coordinates must be integers");
+          if ( c >= INT_MAX ) throw std::runtime_error("holes: coordinate too large");
+          if ( c < 0 ) throw std::runtime_error("holes: negative coordinate");
+        }
+        job->holes.push_back(std::make_pair((int)v.array[i], (int)v.array[i + 1]));
+      }
+    }
+    else if ( key == "size" ) job->size = (int)v.num;
+    else if ( key == "symmetric" ) job->symmetric = v.num != 0;
+    else if ( key == "alpha" ) job->alpha = v.num;
+    else if ( key == "beta" ) job->beta = v.num;
+    else if ( key == "decayFactor" ) job->decayFactor = v.num;
+    else if ( key == "lambda" ) job->lambda = v.num;
+    else if ( key == "maxIterations" ) job->maxIterations = (int)v.num;
+    else if ( key == "timeLimit" ) job->timeLimit = v.num;
+    else if ( key == "seed" ) job->seed = (unsigned int)v.num;
+    else throw std::runtime_error("unknown field: " + key);
+  }
+  if ( job->board.empty() == job->holes.empty() ) throw std::runtime_error("expected either 'board' or 'holes'");
+  return job;
+}
+
+/** handle one request line: a job, or a cancellation
+* @return false if the server no longer accepts jobs
+*/
+static bool handleLine ( JobFeeder& feeder , const std::string& line , const std::shared_ptr<JobOutput>& output )
+{
+  if ( line.find_first_not_of(" \t\r") == std::string::npos ) return true;
+  JsonObject request;
+  std::string id;
+  try {
+    request = JsonLineParser::parse(line);
+    if ( request.count("id") ) {
+      const JsonValue& v = request["id"];
+      id = ( v.type == JsonValue::STRING ) ? v.str : std::to_string((long long)v.num);
+    }
+    if ( request.count("cancel") ) {
+      const JsonValue& v = request["cancel"];
+      std::string target = ( v.type == JsonValue::STRING ) ? v.str : std::to_string((long long)v.num);
+      int count = feeder.cancel(output, target);
+      if ( count == 0 ) output->writeLine(JsonLineWriter().add("id", target).add("status", "error").add("error", "no such job").str());
+      return true;
+    }
+    std::shared_ptr<SolverJob> job = parseJob(request, output);
+    if ( !feeder.park(job) ) return false;         // reported as rejected
+  } catch ( std::exception& e ) {
+    output->writeLine(JsonLineWriter().add("id", id).add("status", "error").add("error", e.what()).str());
+  }
+  return true;
+}
+
+/** read request lines from a socket connection until the client closes its side; results keep
+* flowing back on the same connection (the descriptor is closed when its last job has reported)
+*/
+static void serveConnection ( SolverServer& server , int fd , int readAhead )
+{
+  std::shared_ptr<JobOutput> output(new JobOutput(fd, true));
+  JobFeeder feeder(server, readAhead);
+  std::string pending;
+  char buffer[65536];
+  while ( true ) {
+    ssize_t r = read(fd, buffer, sizeof(buffer));
+    if ( r < 0 && errno == EINTR ) continue;
+    if ( r <= 0 ) break;
+    pending.append(buffer, r);
+    size_t begin = 0, end;
+    while ( ( end = pending.find('\n', begin) ) != std::string::npos ) {
+      if ( !handleLine(feeder, pending.substr(begin, end - begin), output) ) return;
+      begin = end + 1;
+    }
+    pending.erase(0, begin);
+  }
+  if ( !pending.empty() ) handleLine(feeder, pending, output);
+  feeder.finish();                         // every job is in the server queue from here on
+
+  // end of requests: a half-closed client still waits for its results, a vanished one cancels its jobs
+  while ( output.use_count() > 1 && !output->isClosed() ) {
+    struct pollfd p = { fd, 0, 0 };
+    if ( poll(&p, 1, 100) > 0 && ( p.revents & ( POLLHUP | POLLERR ) ) ) output->markClosed();
+  }
+  if ( output->isClosed() ) server.cancelAll(output);
+}
+
+int main ( int argc , char const *argv[] )
+{
+  try
+  {
+    int workers = std::max(1u, std::thread::hardware_concurrency());
+    int queueCapacity = -1;               // default: 2 jobs per worker
+    int cacheSize = 8;                    // instances kept in memory
+    std::string cacheDir = "";            // on-disk instance cache (empty: disabled)
+    std::string socketPath = "";          // Unix domain socket (empty: stdin/stdout)
+    int readAhead = 64;                   // jobs parked per client while the queue is full (cancel lines are still read)
+
+    for ( int i = 1 ; i < argc ; ++i ) {
+      std::string arg = argv[i];
+      if ( arg.find("--workers=") == 0 ) {
+        workers = std::stoi(arg.substr(10));
+      } else if ( arg.find("--queue=") == 0 ) {
+        queueCapacity = std::stoi(arg.substr(8));
+      } else if ( arg.find("--cacheSize=") == 0 ) {
+        cacheSize = std::stoi(arg.substr(12));
+      } else if ( arg.find("--cacheDir=") == 0 ) {
+        cacheDir = arg.substr(11);
+      } else if ( arg.find("--socket=") == 0 ) {
+        socketPath = arg.substr(9);
+      } else if ( arg.find("--readAhead=") == 0 ) {
+        readAhead = std::stoi(arg.substr(12));
+      } else {
+        throw std::runtime_error("usage: ./main_server.out [--workers=N --queue=2N --cacheSize=8 --cacheDir=dir --socket=path --readAhead=64]");
+      }
+    }
+    if ( queueCapacity < 0 ) queueCapacity = 2 * workers;
+
+    signal(SIGPIPE, SIG_IGN);              // a vanished client shows up as a failed write
+    SolverServer server(workers, queueCapacity, cacheSize, cacheDir);
+
+    if ( socketPath.empty() ) {
+      std::shared_ptr<JobOutput> output(new JobOutput(STDOUT_FILENO, false));
+      JobFeeder feeder(server, readAhead);
+      std::string line;
+      while ( std::getline(std::cin, line) ) {
+        if ( !handleLine(feeder, line, output) ) break;
+      }
+      feeder.finish();
+      server.shutdown();                    // end of input: finish the queued jobs
+      return 0;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ( listener < 0 ) throw std::runtime_error("cannot create socket");
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if ( socketPath.size() >= sizeof(addr.sun_path) ) throw std::runtime_error("socket path too long");
+    strcpy(addr.sun_path, socketPath.c_str());
+    unlink(socketPath.c_str());
+    if ( bind(listener, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 64) != 0 ) {
+      throw std::runtime_error("cannot listen on " + socketPath + ": " + strerror(errno));
+    }
+    std::cerr << "listening on " << socketPath << " (" << workers << " workers, queue " << queueCapacity << ")" << std::endl;
+    while ( true ) {
+      int fd = accept(listener, NULL, NULL);
+      if ( fd < 0 ) {
+        if ( errno == EINTR ) continue;
+        break;
+      }
+      std::thread(serveConnection, std::ref(server), fd, readAhead).detach();
+    }
+    close(listener);
+    unlink(socketPath.c_str());
+  }
+  catch(std::exception& e)
+  {
+    std::cout << ">>>EXCEPTION: " << e.what() << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file test_alloc.cpp
+ * @brief check that the tabu search does no heap allocation once started
+ *
+ * Global operator new/delete are replaced by counting versions. For every distance storage
+ * (full matrix, packed symmetric matrix, grid distances) the search is started and warmed up,
+ * then resumed over enough iterations for shakes and elite restarts to happen: the allocation
+ * counter must not move. Exit status 1 on failure.
+ */
+
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <random>
+#include <set>
+#include <iostream>
+
+#include "TSPSolver.h"
+
+static std::atomic<long> allocations(0);
+
+// the replacements pair malloc and free themselves (g++ only sees free applied to operator new's result)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new ( size_t size )
+{
+  ++allocations;
+  void* p = malloc(size ? size : 1);
+  if ( !p ) throw std::bad_alloc();
+  return p;
+}
+void* operator new[] ( size_t size ) { return operator new(size); }
+void operator delete ( void* p ) noexcept { free(p); }
+void operator delete[] ( void* p ) noexcept { free(p); }
+void operator delete ( void* p , size_t ) noexcept { free(p); }
+void operator delete[] ( void* p , size_t ) noexcept { free(p); }
+#pragma GCC diagnostic pop
+
+/** random board of n distinct holes on a side x side grid */
+static void randomBoard ( TSP& tsp , int n , int side , unsigned int seed )
+{
+  std::mt19937 rng(seed);
+  std::set<std::pair<int, int>> used;
+  while ( (int)used.size() < n ) used.insert(std::make_pair((int)( rng() % side ), (int)( rng() % side )));
+  tsp.holes.assign(used.begin(), used.end());
+  tsp.n = n;
+  tsp.gridSize = side;
+}
+
+int main ( )
+{
+  const int warmup = 500;
+  const int iterations = 20000;
+  const char* modes[] = { "matrix", "symmetric", "grid" };
+  bool ok = true;
+
+  for ( int mode = 0 ; mode < 3 ; ++mode ) {
+    TSP tsp;
+    randomBoard(tsp, 60, 40, 7);
+    if ( mode == 2 ) tsp.useGridDistances(true);
+    else tsp.computeCostMatrix(mode == 1);
+
+    TSPSolver solver("", 0.75, 0.5, 0.9, 0.01);
+    solver.setVerbose(false);
+    solver.setSeed(1);
+    Instrumentation instr(0);                       // counters only: no trace events, no allocation
+    solver.setInstrumentation(&instr);
+    TSPSolution init(tsp);
+    solver.start(tsp, init);
+    solver.resume(tsp, warmup);
+
+    long shakes = instr.get(Instrumentation::SHAKES);
+    long restarts = instr.get(Instrumentation::ELITE_RESTARTS);
+    long before = allocations;
+    bool running = solver.resume(tsp, iterations);
+    long allocated = allocations - before;
+    shakes = instr.get(Instrumentation::SHAKES) - shakes;
+    restarts = instr.get(Instrumentation::ELITE_RESTARTS) - restarts;
+
+    bool passed = allocated == 0 && running && shakes > 0 && restarts > 0;
+    std::cout << ( passed ? "PASS " : "FAIL " ) << modes[mode] << ": " << allocated << " allocations in "
+              << iterations << " iterations (" << shakes << " shakes, " << restarts << " elite restarts)" << std::endl;
+    ok = ok && passed;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+// perf_counters.h
+// Hardware/software performance counters of the calling thread through perf_event_open(2), for the
+// in-process benchmark binaries. Every event is opened on its own, so a machine (VM, container,
+// perf_event_paranoid > 2) that lacks some of them still reports the others; events that cannot be
+// opened are reported as unavailable (empty CSV fields) instead of failing the benchmark.
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+struct PerfEventSpec {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+};
+
+// Counted events, in CSV column order
+static const PerfEventSpec PERF_EVENTS[] = {
+    {"cycles",           PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions",     PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache_references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+    {"cache_misses",     PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branches",         PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {"branch_misses",    PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"l1d_read_misses",  PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                             | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {"task_clock_ns",    PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    {"page_faults",      PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    {"context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+};
+static const int NUM_PERF_EVENTS = sizeof(PERF_EVENTS) / sizeof(PERF_EVENTS[0]);
+
+// One reading of every event over a start()/stop() interval (-1: event unavailable)
+struct PerfSample {
+    double value[NUM_PERF_EVENTS];
+    PerfSample() { for (int e = 0; e < NUM_PERF_EVENTS; ++e) value[e] = -1.0; }
+};
+
+class PerfCounters {
+public:
+    PerfCounters() { for (int e = 0; e < NUM_PERF_EVENTS; ++e) fd[e] = -1; }
+    ~PerfCounters() { close(); }
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Open every event for the calling thread (user space only); returns the number opened
+    int open() {
+        close();
+        int opened = 0;
+        for (int e = 0; e < NUM_PERF_EVENTS; ++e) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_EVENTS[e].type;
+            attr.config = PERF_EVENTS[e].config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            // more events than hardware counters: the kernel multiplexes them, values are scaled
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fd[e] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            if (fd[e] >= 0) ++opened;
+        }
+        return opened;
+    }
+
+    void close() {
+        for (int e = 0; e < NUM_PERF_EVENTS; ++e) {
+            if (fd[e] >= 0) ::close(fd[e]);
+            fd[e] = -1;
+        }
+    }
+
+    bool available(int e) const { return fd[e] >= 0; }
+    bool anyHardware() const {
+        for (int e = 0; e < NUM_PERF_EVENTS; ++e) if (fd[e] >= 0 && PERF_EVENTS[e].type != PERF_TYPE_SOFTWARE) return true;
+        return false;
+    }
+
+    void start() {
+        for (int e = 0; e < NUM_PERF_EVENTS; ++e) {
+            if (fd[e] < 0) continue;
+            ioctl(fd[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    PerfSample stop() {
+        PerfSample s;
+        for (int e = 0; e < NUM_PERF_EVENTS; ++e) {
+            if (fd[e] >= 0) ioctl(fd[e], PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for (int e = 0; e < NUM_PERF_EVENTS; ++e) {
+            if (fd[e] < 0) continue;
+            uint64_t data[3];   // value, time enabled, time running
+            if (read(fd[e], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+            if (data[2] == 0) s.value[e] = (data[1] == 0) ? 0.0 : -1.0;   // never scheduled on a counter
+            else s.value[e] = (double)data[0] * ((double)data[1] / (double)data[2]);
+        }
+        return s;
+    }
+
+private:
+    int fd[NUM_PERF_EVENTS];
+};
+
+// Mean of the samples of a phase, event by event (-1 where any sample lacks the event)
+inline PerfSample mean_sample(const std::vector<PerfSample>& samples) {
+    PerfSample m;
+    if (samples.empty()) return m;
+    for (int e = 0; e < NUM_PERF_EVENTS; ++e) {
+        double sum = 0.0;
+        bool ok = true;
+        for (const PerfSample& s : samples) {
+            if (s.value[e] < 0) ok = false;
+            sum += s.value[e];
+        }
+        if (ok) m.value[e] = sum / samples.size();
+    }
+    return m;
+}
+
+// Index of an event in PERF_EVENTS (-1 if unknown)
+inline int perf_event_index(const std::string& name) {
+    for (int e = 0; e < NUM_PERF_EVENTS; ++e) if (name == PERF_EVENTS[e].name) return e;
+    return -1;
+}
+
+// a / b for two events of a sample (-1 if either is unavailable or b is 0)
+inline double perf_ratio(const PerfSample& s, const char* a, const char* b) {
+    int ia = perf_event_index(a), ib = perf_event_index(b);
+    if (ia < 0 || ib < 0 || s.value[ia] < 0 || s.value[ib] <= 0) return -1.0;
+    return s.value[ia] / s.value[ib];
+}
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,318 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <limits>
+
+#include "part1/generate_board.h"
+
+#include "part2/TSPSolver.h"
+#include "part2/TSP.h"
+#include "part2/TourConstruction.h"
+#include "part2/WorkStealingPool.h"
+
+// Racing / successive-halving tuner: every candidate starts on a small iteration budget, candidates that are
+// statistically worse than the leader (and at least the worse half) are dropped, survivors continue their
+// *same* search (TSPSolver::resume) with a doubled budget, up to the full maxIterations.
+
+const std::string OUTPUT_DIR = "parameter_tuning";
+const std::string CSV_FILENAME = "race_results.csv";   // same columns as tuning_results.csv
+
+const std::vector<int> SIZES = {5, 10, 15, 20, 30};
+const std::vector<double> DENSITIES = {0.05, 0.1, 0.15, 0.2};
+const int REPEATS = 3;
+
+struct Range {
+    double lo;
+    double hi;
+};
+
+struct Params {
+    double alpha;
+    double beta;
+    double decayFactor;
+    double lambda;
+};
+
+// One (candidate, board, seed) search, kept alive between rounds
+struct RaceRun {
+    std::unique_ptr<TSPSolver> solver;
+    double time_sec = 0.0;
+};
+
+struct Candidate {
+    Params params;
+    bool alive = true;
+    std::vector<RaceRun> runs;   // one per instance (board x seed)
+};
+
+struct RaceBoard {
+    int repeat;
+    std::string filename;
+    TSP tsp;
+};
+
+bool file_exists(const std::string& name) {
+    std::ifstream f(name.c_str());
+    return f.good();
+}
+
+std::string combine_path(const std::string& dir, const std::string& filename) {
+    if (!dir.empty() && dir.back() != '/') {
+        return dir + "/" + filename;
+    }
+    return dir + filename;
+}
+
+// Parse "lo:hi" (or a single value for a fixed parameter)
+Range parseRange(const std::string& value) {
+    size_t colon = value.find(':');
+    if (colon == std::string::npos) {
+        double v = std::stod(value);
+        return {v, v};
+    }
+    return {std::stod(value.substr(0, colon)), std::stod(value.substr(colon + 1))};
+}
+
+// Drop candidates statistically worse than the leader, then keep at most the better half.
+// Costs are normalized per instance by the best value found on it, so boards of different size weigh the same.
+int eliminate(std::vector<Candidate>& candidates, int instances) {
+    std::vector<int> alive;
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        if (candidates[c].alive) alive.push_back(c);
+    }
+    if (alive.size() <= 1) return alive.size();
+
+    std::vector<double> bestOnInstance(instances, std::numeric_limits<double>::infinity());
+    for (int c : alive) {
+        for (int k = 0; k < instances; ++k) {
+            bestOnInstance[k] = std::min(bestOnInstance[k], candidates[c].runs[k].solver->getIncumbentValue());
+        }
+    }
+
+    std::vector<double> mean(candidates.size(), 0.0), sd(candidates.size(), 0.0);
+    for (int c : alive) {
+        for (int k = 0; k < instances; ++k) {
+            mean[c] += candidates[c].runs[k].solver->getIncumbentValue() / bestOnInstance[k];
+        }
+        mean[c] /= instances;
+        for (int k = 0; k < instances; ++k) {
+            double d = candidates[c].runs[k].solver->getIncumbentValue() / bestOnInstance[k] - mean[c];
+            sd[c] += d * d;
+        }
+        sd[c] = std::sqrt(sd[c] / std::max(1, instances - 1));
+    }
+
+    std::sort(alive.begin(), alive.end(), [&](int a, int b) { return mean[a] < mean[b]; });
+    int leader = alive.front();
+    size_t keep = (alive.size() + 1) / 2;
+
+    int survivors = 0;
+    for (size_t r = 0; r < alive.size(); ++r) {
+        int c = alive[r];
+        double se = std::sqrt((sd[c] * sd[c] + sd[leader] * sd[leader]) / instances);
+        bool dominated = (c != leader) && (mean[c] - mean[leader] > 2.0 * se);
+        if (dominated || r >= keep) {
+            candidates[c].alive = false;
+            candidates[c].runs.clear();            // release the search state
+        } else {
+            ++survivors;
+        }
+    }
+    return survivors;
+}
+
+int main(int argc, char* argv[]) {
+    Range alphaRange = {0.2, 1.0};
+    Range betaRange = {0.1, 0.7};
+    Range decayRange = {0.8, 0.99};
+    Range lambdaRange = {0.0, 0.1};
+    int num_candidates = 32;
+    int seeds_per_board = 2;
+    int max_iterations = 1000;
+    int first_budget = 60;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int base_seed = static_cast<unsigned int>(time(nullptr));
+    ConstructionMethod init_method = CONSTRUCT_RANDOM;   // initial tour of every run
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.find("--alpha=") == 0) alphaRange = parseRange(arg.substr(8));
+            else if (arg.find("--beta=") == 0) betaRange = parseRange(arg.substr(7));
+            else if (arg.find("--decayFactor=") == 0) decayRange = parseRange(arg.substr(14));
+            else if (arg.find("--lambda=") == 0) lambdaRange = parseRange(arg.substr(9));
+            else if (arg.find("--candidates=") == 0) num_candidates = std::stoi(arg.substr(13));
+            else if (arg.find("--seeds=") == 0) seeds_per_board = std::stoi(arg.substr(8));
+            else if (arg.find("--maxIterations=") == 0) max_iterations = std::stoi(arg.substr(16));
+            else if (arg.find("--firstBudget=") == 0) first_budget = std::stoi(arg.substr(14));
+            else if (arg.find("--threads=") == 0) num_threads = std::stoi(arg.substr(10));
+            else if (arg.find("--seed=") == 0) base_seed = std::stoul(arg.substr(7));
+            else if (arg.find("--init=") == 0) {
+                if (!TourConstruction::parseMethod(arg.substr(7), init_method)) throw std::invalid_argument(arg);
+            }
+            else std::cerr << "Warning: Unknown parameter: " << arg << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "usage: ./race_parameters.out [--alpha=lo:hi --beta=lo:hi --decayFactor=lo:hi --lambda=lo:hi "
+                     "--candidates=32 --seeds=2 --maxIterations=1000 --firstBudget=60 --threads=N --seed=S "
+                     "--init=random|nn|greedy|sfc|christofides]" << std::endl;
+        return 1;
+    }
+
+    std::string mkdir_command = "mkdir -p " + OUTPUT_DIR;
+    if (std::system(mkdir_command.c_str()) != 0) {
+        std::cerr << "Error creating directory " << OUTPUT_DIR << std::endl;
+        return 1;
+    }
+
+    bool first_write = !file_exists(CSV_FILENAME);
+    std::ofstream csv_file(CSV_FILENAME, std::ios_base::app);
+    if (!csv_file.is_open()) {
+        std::cerr << "Error: Could not open CSV file: " << CSV_FILENAME << std::endl;
+        return 1;
+    }
+    if (first_write) {
+        csv_file << "size,density,holes,repeat,alpha,beta,decayFactor,lambda,final_cost,time_sec,board_filename\n";
+    }
+
+    std::mt19937 sampler(base_seed);
+    auto sample = [&sampler](const Range& r) {
+        return std::uniform_real_distribution<double>(r.lo, std::max(r.lo, r.hi))(sampler);
+    };
+
+    WorkStealingPool pool(num_threads);
+    long long spent_iterations = 0, grid_iterations = 0;
+
+    for (int size : SIZES) {
+        int total_cells = size * size;
+        for (double density : DENSITIES) {
+            int num_holes = static_cast<int>(total_cells * density);
+            if (num_holes < 3 || num_holes > 0.6 * total_cells) {
+                continue;
+            }
+
+            // boards of this (size, density) class, loaded once
+            std::vector<std::unique_ptr<RaceBoard>> boards;
+            for (int r = 0; r < REPEATS; ++r) {
+                std::unique_ptr<RaceBoard> board(new RaceBoard());
+                board->repeat = r;
+                board->filename = combine_path(OUTPUT_DIR, "race_" + std::to_string(size) + "_" + std::to_string(num_holes) + "_" + std::to_string(r) + ".dat");
+                generateBoard(size, num_holes, board->filename, base_seed + 1000000u * size + 1000u * num_holes + r);
+                if (!file_exists(board->filename)) continue;
+                board->tsp.read(board->filename.c_str());
+                boards.push_back(std::move(board));
+            }
+            int instances = boards.size() * seeds_per_board;
+            if (instances == 0) continue;
+
+            // candidates sampled from the continuous ranges
+            std::vector<Candidate> candidates(num_candidates);
+            for (int c = 0; c < num_candidates; ++c) {
+                candidates[c].params = {sample(alphaRange), sample(betaRange), sample(decayRange), sample(lambdaRange)};
+                candidates[c].runs.resize(instances);
+                for (int k = 0; k < instances; ++k) {
+                    const Params& p = candidates[c].params;
+                    const TSP& tsp = boards[k / seeds_per_board]->tsp;
+                    RaceRun& run = candidates[c].runs[k];
+                    run.solver.reset(new TSPSolver("", p.alpha, p.beta, p.decayFactor, p.lambda));
+                    run.solver->setVerbose(false);
+                    run.solver->setSeed(base_seed + 7919u * k + c);
+                    TSPSolution init(tsp);
+                    if (!TourConstruction(tsp).build(init_method, init)) run.solver->initRnd(init);
+                    try {
+                        run.solver->start(tsp, init);
+                    } catch (const std::logic_error& e) {
+                        candidates[c].alive = false;   // parameters invalid for this board size
+                    }
+                }
+                if (!candidates[c].alive) candidates[c].runs.clear();
+            }
+
+            // racing rounds
+            int budget = std::min(first_budget, max_iterations);
+            int alive = 0;
+            for (const Candidate& cand : candidates) alive += cand.alive;
+            while (alive > 0) {
+                for (Candidate& cand : candidates) {
+                    if (!cand.alive) continue;
+                    for (int k = 0; k < instances; ++k) {
+                        RaceRun* run = &cand.runs[k];
+                        const TSP* tsp = &boards[k / seeds_per_board]->tsp;
+                        int iterations = budget - run->solver->getIteration();
+                        spent_iterations += std::max(0, iterations);
+                        pool.submit([run, tsp, iterations]() {
+                            auto start_time = std::chrono::high_resolution_clock::now();
+                            run->solver->resume(*tsp, iterations);
+                            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_time;
+                            run->time_sec += elapsed.count();
+                        });
+                    }
+                }
+                pool.wait();
+
+                if (budget >= max_iterations || alive == 1) break;
+                alive = eliminate(candidates, instances);
+                budget = std::min(2 * budget, max_iterations);
+            }
+            grid_iterations += 81LL * instances * max_iterations;
+
+            // winner: best mean normalized cost among the survivors
+            while (eliminate(candidates, instances) > 1) { }
+            int winner = -1;
+            for (size_t c = 0; c < candidates.size(); ++c) {
+                if (candidates[c].alive) { winner = c; break; }
+            }
+            if (winner < 0) {
+                std::cout << "No valid configuration for size=" << size << ", density=" << density << std::endl;
+                continue;
+            }
+
+            const Candidate& best = candidates[winner];
+            for (size_t b = 0; b < boards.size(); ++b) {
+                double final_cost = std::numeric_limits<double>::infinity();
+                double time_sec = 0.0;
+                for (int s = 0; s < seeds_per_board; ++s) {
+                    const RaceRun& run = best.runs[b * seeds_per_board + s];
+                    final_cost = std::min(final_cost, run.solver->getIncumbentValue());
+                    time_sec += run.time_sec / seeds_per_board;
+                }
+                csv_file << size << ","
+                         << density << ","
+                         << num_holes << ","
+                         << boards[b]->repeat << ","
+                         << best.params.alpha << ","
+                         << best.params.beta << ","
+                         << best.params.decayFactor << ","
+                         << best.params.lambda << ","
+                         << std::fixed << std::setprecision(4) << final_cost << ","
+                         << std::fixed << std::setprecision(4) << time_sec << ","
+                         << boards[b]->filename << "\n";
+                csv_file.unsetf(std::ios_base::fixed);
+                csv_file << std::setprecision(6);
+                std::remove(boards[b]->filename.c_str());
+            }
+            csv_file.flush();
+
+            std::cout << "Race winner for size=" << size << ", density=" << density
+                      << ": alpha=" << best.params.alpha << " beta=" << best.params.beta
+                      << " decayFactor=" << best.params.decayFactor << " lambda=" << best.params.lambda << std::endl;
+        }
+    }
+
+    csv_file.close();
+    std::cout << "Racing complete. Results saved to " << CSV_FILENAME << std::endl;
+    std::cout << "Iterations: " << spent_iterations << " (a full 81-point grid would take " << grid_iterations << ")" << std::endl;
+    return 0;
+}
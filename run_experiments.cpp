@@ -7,11 +7,15 @@
 #include <utility>
 #include <cstdlib>
 #include <cstdio>
-#include <chrono>
 #include <array>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include "benchmark.h"
+#include "part2/TSP.h"
+#include "part2/TSPSolver.h"
+#include "part2/LowerBound.h"
+
 struct Params {
     double alpha;
     double beta;
@@ -97,10 +101,11 @@ int main() {
     int repeats = 3;
 
     std::string generator = "part1/generate_board.out";
-    std::map<std::string, std::string> solvers = {
-        {"tabu", "part2/main_tabu.out"},
-        {"cplex", "part1/main_cplex.out"}
-    };
+    std::vector<std::string> solvers = {"cplex", "tabu"};
+    std::string cplex_exec = "part1/main_cplex.out";
+    int tabu_length = 10;
+    int max_iterations = 1000;
+    std::string cplex_options = " --timeLimit=600 --parallelMode=deterministic"; // keep every row bounded in time
     std::string param_csv = "summary_tuning.csv";
     std::string output_dir = "experiments";
     std::string result_csv = "benchmark_results.csv";
@@ -134,57 +139,64 @@ int main() {
                     continue;
                 }
 
+                // Lower bound (Held-Karp) for the optimality gap of every solver
+                TSP tspInstance;
+                tspInstance.read(fname.c_str());
+                double lower_bound = TSPLowerBound(tspInstance).heldKarp();
+
                 // Prepare CSV
                 if (first_write) {
                     outfile.open(result_csv, std::ios::out);
-                    outfile << "solver,size,density,holes,repeat,filename,final_cost,time_sec\n";
+                    outfile << "solver,size,density,holes,repeat,filename,final_cost,time_sec,lower_bound,gap\n";
                     first_write = false;
                 } else {
                     outfile.open(result_csv, std::ios::app);
                 }
 
-                for (const auto& solver : solvers) {
-                    const std::string& solver_name = solver.first;
-                    const std::string& solver_exec = solver.second;
-
-                    std::string cmd = solver_exec + " " + fname;
+                for (const std::string& solver_name : solvers) {
+                    double final_cost = -1.0;
+                    double elapsed_sec = 0.0;
 
                     if (solver_name == "tabu") {
+                        // in-process: the board is already loaded, only the search is timed
                         auto it = bestParams.find({size, density});
-                        if (it != bestParams.end()) {
-                            Params p = it->second;
-                            cmd += " --alpha=" + std::to_string(p.alpha) +
-                                   " --beta=" + std::to_string(p.beta) +
-                                   " --decayFactor=" + std::to_string(p.decayFactor) +
-                                   " --lambda=" + std::to_string(p.lambda);
-
-                            std::cout << "[DEBUG] Running 'tabu' with params: "
-                                      << "alpha=" << p.alpha << ", "
-                                      << "beta=" << p.beta << ", "
-                                      << "decayFactor=" << p.decayFactor << ", "
-                                      << "lambda=" << p.lambda << "\n";
-                        } else {
+                        if (it == bestParams.end()) {
                             std::cerr << "Missing parameters for tabu with size=" << size
                                       << ", density=" << density << "\n";
                             continue;
                         }
-                    }
-
-                    auto start = std::chrono::high_resolution_clock::now();
-                    std::string output = execCommand(cmd);
-                    auto end = std::chrono::high_resolution_clock::now();
-                    std::chrono::duration<double> elapsed = end - start;
-
-                    double final_cost = -1.0;
-                    std::istringstream iss(output);
-                    std::string line;
-                    while (std::getline(iss, line)) {
-                        if (line.rfind("FINAL_VALUE", 0) == 0) {
-                            size_t pos = line.find(":");
-                            if (pos != std::string::npos) {
-                                final_cost = std::stod(line.substr(pos + 1));
+                        Params p = it->second;
+                        std::cout << "[DEBUG] Running 'tabu' with params: "
+                                  << "alpha=" << p.alpha << ", "
+                                  << "beta=" << p.beta << ", "
+                                  << "decayFactor=" << p.decayFactor << ", "
+                                  << "lambda=" << p.lambda << "\n";
+
+                        TSPSolver tspSolver("", p.alpha, p.beta, p.decayFactor, p.lambda);
+                        tspSolver.setVerbose(false);
+                        TSPSolution initSol(tspInstance), bestSol(tspInstance);
+                        tspSolver.initRnd(initSol);
+                        double start = now_sec();
+                        tspSolver.solve(tspInstance, initSol, tabu_length, max_iterations, bestSol);
+                        elapsed_sec = now_sec() - start;
+                        final_cost = tspSolver.evaluate(bestSol, tspInstance);
+                    } else {
+                        // CPLEX is only available as a separate executable
+                        std::string cmd = cplex_exec + " " + fname + cplex_options;
+                        double start = now_sec();
+                        std::string output = execCommand(cmd);
+                        elapsed_sec = now_sec() - start;
+
+                        std::istringstream iss(output);
+                        std::string line;
+                        while (std::getline(iss, line)) {
+                            if (line.rfind("FINAL_VALUE", 0) == 0) {
+                                size_t pos = line.find(":");
+                                if (pos != std::string::npos) {
+                                    final_cost = std::stod(line.substr(pos + 1));
+                                }
+                                break;
                             }
-                            break;
                         }
                     }
 
@@ -195,12 +207,15 @@ int main() {
                             << r << ","
                             << fname << ","
                             << final_cost << ","
-                            << elapsed.count() << "\n";
+                            << elapsed_sec << ","
+                            << lower_bound << ","
+                            << (final_cost >= 0 ? TSPLowerBound::gap(final_cost, lower_bound) : -1.0) << "\n";
 
                     std::cout << "✓ " << solver_name << " | size=" << size
                               << " density=" << density << " r=" << r
                               << " -> cost=" << final_cost
-                              << " (" << elapsed.count() << "s)\n";
+                              << " lb=" << lower_bound
+                              << " (" << elapsed_sec << "s)\n";
                 }
 
                 outfile.close();
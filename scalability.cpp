@@ -0,0 +1,273 @@
+// scalability.cpp
+// Scalability suite for large boards (1k - 100k holes): boards are sampled in memory with fixed
+// seeds in three layouts (uniform, clustered, grid-aligned component arrays) and for every size the
+// suite reports cost matrix time and memory, time per tabu iteration (one full neighborhood scan),
+// time to get within X% of the best known value, and how all of this behaves when 1..T independent
+// searches share the instance. Sizes whose O(n^2) matrices do not fit in memory are skipped.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <thread>
+#include <memory>
+#include <limits>
+#include <iomanip>
+#include <stdexcept>
+#include <cmath>
+#include <sys/stat.h>
+
+#include "benchmark.h"
+#include "part1/generate_board.h"
+
+#include "part2/TSP.h"
+#include "part2/TSPSolver.h"
+
+struct SuiteOptions {
+    std::vector<int> sizes = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+    std::vector<std::string> layouts = {"uniform", "clustered", "grid"};
+    std::vector<int> threads = {1, 2, 4, 8};
+    std::vector<double> within = {5.0, 2.0, 1.0};   // percent above the best known value
+    double density = 0.1;          // holes / cells: sets the board side for a given size
+    double timeBudget = 30.0;      // seconds of search per run
+    int maxIterations = 1000000;
+    double memLimitMb = -1.0;      // < 0: half of the available memory
+    unsigned int seed = 12345;
+    bool pin = true;
+    std::string output = "scalability_results.csv";
+    std::string bestKnownFile = "best_known.csv";
+    std::string label = "";
+};
+
+// Value trajectory of one search: (seconds since start, incumbent) at every improvement
+typedef std::vector<std::pair<double, double>> Trajectory;
+
+struct RunResult {
+    long iterations = 0;
+    double searchSec = 0.0;
+    double bestValue = std::numeric_limits<double>::infinity();
+    Trajectory trajectory;
+};
+
+bool file_exists(const std::string& filename) {
+    struct stat buffer;
+    return (stat(filename.c_str(), &buffer) == 0);
+}
+
+template <class T>
+std::vector<T> parse_list(const std::string& s) {
+    std::vector<T> out;
+    std::istringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        std::istringstream is(item);
+        T v;
+        if (is >> v) out.push_back(v);
+    }
+    return out;
+}
+
+// Bytes of the O(n^2) structures: packed distance matrix plus one packed frequency matrix per search
+double quadratic_memory_mb(int n, int searches) {
+    double packed = (double)n * (n + 1) / 2 * sizeof(double);
+    return packed * (1 + searches) / (1024.0 * 1024.0);
+}
+
+// Time-budgeted search, recording the incumbent trajectory
+RunResult run_search(const TSP& tsp, unsigned int seed, const SuiteOptions& opt, int cpu) {
+    if (opt.pin) pin_thread(cpu);
+    RunResult res;
+    TSPSolver solver("");
+    solver.setVerbose(false);
+    solver.setSeed(seed);
+    TSPSolution init(tsp);
+    solver.initRnd(init);
+
+    double t0 = now_sec();
+    solver.start(tsp, init);
+    double searchStart = now_sec();
+    // points are the length of the incumbent tour itself, evaluated only when the incumbent changes
+    double incumbentValue = solver.getIncumbentValue();
+    res.trajectory.push_back({searchStart - t0, solver.evaluate(solver.getIncumbent(), tsp)});
+    double now = searchStart;
+    while (now - t0 < opt.timeBudget && solver.getIteration() < opt.maxIterations) {
+        bool running = solver.resume(tsp, 1);    // one iteration = one full neighborhood scan
+        now = now_sec();
+        if (solver.getIncumbentValue() != incumbentValue) {
+            incumbentValue = solver.getIncumbentValue();
+            res.trajectory.push_back({now - t0, solver.evaluate(solver.getIncumbent(), tsp)});
+        }
+        if (!running) break;
+    }
+    res.iterations = solver.getIteration();
+    res.searchSec = now - searchStart;
+    res.bestValue = res.trajectory.back().second;
+    return res;
+}
+
+// Earliest time at which any of the searches had an incumbent <= target (-1: never)
+double time_to_target(const std::vector<RunResult>& runs, double target) {
+    double best = -1.0;
+    for (const RunResult& r : runs) {
+        for (const auto& point : r.trajectory) {
+            if (point.second <= target) {
+                if (best < 0 || point.first < best) best = point.first;
+                break;
+            }
+        }
+    }
+    return best;
+}
+
+std::map<std::string, double> load_best_known(const std::string& filename) {
+    std::map<std::string, double> best;
+    std::ifstream in(filename);
+    std::string line;
+    std::getline(in, line); // skip header
+    while (std::getline(in, line)) {
+        size_t comma = line.rfind(',');
+        if (comma == std::string::npos) continue;
+        best[line.substr(0, comma)] = std::stod(line.substr(comma + 1));
+    }
+    return best;
+}
+
+void save_best_known(const std::string& filename, const std::map<std::string, double>& best) {
+    std::ofstream out(filename);
+    out << "layout,holes,seed,value\n";
+    out << std::setprecision(10);
+    for (const auto& b : best) out << b.first << "," << b.second << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    SuiteOptions opt;
+    int hw = std::max(1u, std::thread::hardware_concurrency());
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.find("--sizes=") == 0) opt.sizes = parse_list<int>(arg.substr(8));
+            else if (arg.find("--layouts=") == 0) opt.layouts = parse_list<std::string>(arg.substr(10));
+            else if (arg.find("--threads=") == 0) opt.threads = parse_list<int>(arg.substr(10));
+            else if (arg.find("--within=") == 0) opt.within = parse_list<double>(arg.substr(9));
+            else if (arg.find("--density=") == 0) opt.density = std::stod(arg.substr(10));
+            else if (arg.find("--timeBudget=") == 0) opt.timeBudget = std::stod(arg.substr(13));
+            else if (arg.find("--maxIterations=") == 0) opt.maxIterations = std::stoi(arg.substr(16));
+            else if (arg.find("--memLimit=") == 0) opt.memLimitMb = std::stod(arg.substr(11));
+            else if (arg.find("--seed=") == 0) opt.seed = std::stoul(arg.substr(7));
+            else if (arg.find("--output=") == 0) opt.output = arg.substr(9);
+            else if (arg.find("--bestKnown=") == 0) opt.bestKnownFile = arg.substr(12);
+            else if (arg.find("--label=") == 0) opt.label = arg.substr(8);
+            else if (arg == "--noPin") opt.pin = false;
+            else {
+                std::cerr << "Usage: " << argv[0] << " [--sizes=1000,10000 --layouts=uniform,clustered,grid --threads=1,2,4,8 "
+                             "--within=5,2,1 --density=0.1 --timeBudget=30 --maxIterations=N --memLimit=MB --seed=S "
+                             "--output=scalability_results.csv --bestKnown=best_known.csv --label=name --noPin]" << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid argument: " << e.what() << std::endl;
+        return 1;
+    }
+    for (const std::string& layout : opt.layouts) {
+        BoardLayout boardLayout;
+        if (!parseLayout(layout, boardLayout)) {
+            std::cerr << "Unknown layout: " << layout << std::endl;
+            return 1;
+        }
+    }
+    if (opt.memLimitMb < 0) opt.memLimitMb = 0.5 * available_memory_mb();
+
+    std::map<std::string, double> bestKnown = load_best_known(opt.bestKnownFile);
+
+    bool write_header = !file_exists(opt.output);
+    std::ofstream out(opt.output, std::ios::app);
+    if (!out) {
+        std::cerr << "Could not open output file: " << opt.output << std::endl;
+        return 1;
+    }
+    if (write_header) {
+        out << "label,layout,holes,board_size,threads,status,matrix_sec,matrix_mb,peak_rss_mb,iterations,sec_per_iteration,best_value,best_known";
+        for (double w : opt.within) out << ",time_within_" << w << "pct";
+        out << "\n";
+    }
+
+    for (const std::string& layout : opt.layouts) {
+        for (int holes : opt.sizes) {
+            int side = (int)std::ceil(std::sqrt(holes / opt.density));
+            unsigned int seed = opt.seed + holes;
+            std::string key = layout + "," + std::to_string(holes) + "," + std::to_string(seed);
+
+            // threads whose quadratic memory fits (each search owns a frequency matrix)
+            std::vector<int> threadCounts;
+            for (int t : opt.threads) {
+                if (t < 1 || t > hw) continue;
+                if (opt.memLimitMb > 0 && quadratic_memory_mb(holes, t) > opt.memLimitMb) {
+                    std::cout << layout << " " << holes << " holes, " << t << " threads: needs ~"
+                              << (long)quadratic_memory_mb(holes, t) << " MB, skipped" << std::endl;
+                    out << opt.label << "," << layout << "," << holes << "," << side << "," << t
+                        << ",skipped_memory,,"  << quadratic_memory_mb(holes, t) << ",,,,,";
+                    for (size_t w = 0; w < opt.within.size(); ++w) out << ",";
+                    out << "\n";
+                    continue;
+                }
+                threadCounts.push_back(t);
+            }
+            if (threadCounts.empty()) continue;
+
+            TSP tsp;
+            tsp.gridSize = side;
+            BoardLayout boardLayout;
+            parseLayout(layout, boardLayout);
+            tsp.holes = sampleHoles(side, holes, boardLayout, seed);
+            tsp.n = tsp.holes.size();
+            double t0 = now_sec();
+            tsp.computeCostMatrix(true);
+            double matrixSec = now_sec() - t0;
+            double matrixMb = quadratic_memory_mb(tsp.n, 0);
+
+            std::vector<std::vector<RunResult>> runsPerCount;
+            for (int t : threadCounts) {
+                std::vector<RunResult> runs(t);
+                std::vector<std::thread> workers;
+                for (int k = 0; k < t; ++k) {
+                    workers.emplace_back([&, k]() { runs[k] = run_search(tsp, seed + 7919u * (k + 1), opt, k); });
+                }
+                for (std::thread& w : workers) w.join();
+                for (const RunResult& r : runs) {
+                    auto it = bestKnown.find(key);
+                    if (it == bestKnown.end() || r.bestValue < it->second) bestKnown[key] = r.bestValue;
+                }
+                runsPerCount.push_back(std::move(runs));
+            }
+
+            // rows are written once the best known value of this instance is final
+            double best = bestKnown[key];
+            for (size_t c = 0; c < threadCounts.size(); ++c) {
+                const std::vector<RunResult>& runs = runsPerCount[c];
+                long iterations = 0;
+                double perIteration = 0.0, bestValue = std::numeric_limits<double>::infinity();
+                for (const RunResult& r : runs) {
+                    iterations += r.iterations;
+                    if (r.iterations > 0) perIteration += r.searchSec / r.iterations / runs.size();
+                    bestValue = std::min(bestValue, r.bestValue);
+                }
+                out << opt.label << "," << layout << "," << tsp.n << "," << side << "," << threadCounts[c]
+                    << ",ok," << matrixSec << "," << matrixMb << "," << peak_rss_mb() << ","
+                    << iterations << "," << perIteration << ","
+                    << std::setprecision(10) << bestValue << "," << best << std::setprecision(6);
+                for (double w : opt.within) out << "," << time_to_target(runs, best * (1.0 + w / 100.0));
+                out << "\n";
+                std::cout << layout << " " << tsp.n << " holes, " << threadCounts[c] << " threads: "
+                          << perIteration << " s/iteration, best " << bestValue << " (best known " << best << ")" << std::endl;
+            }
+            out.flush();
+            save_best_known(opt.bestKnownFile, bestKnown);
+        }
+    }
+
+    std::cout << "Scalability suite complete. Results appended to " << opt.output << std::endl;
+    return 0;
+}